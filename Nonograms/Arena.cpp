@@ -0,0 +1,71 @@
+#include "Arena.h"
+#include "MemoryTracker.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+using namespace std;
+
+static thread_local Arena* currentArena = nullptr;
+static atomic<bool> arenasEnabled(true);
+
+Arena::Arena(size_t chunkSize) : chunkSize(chunkSize)
+{
+	timed = allocationTiming();
+}
+
+Arena::~Arena()
+{
+	for (Chunk& chunk : chunkList)
+		::operator delete(chunk.memory);
+}
+
+void* Arena::allocateSlow(size_t bytes, size_t alignment)
+{
+	auto start = chrono::steady_clock::now();
+	size_t offset = (used + alignment - 1) & ~(alignment - 1);
+	if (active < chunkList.size() && offset + bytes <= chunkList[active].size) //fits after all, only here to be timed
+		used = offset + bytes;
+	else
+	{
+		//the next free chunk big enough, rewinding left them behind. a new one if none is
+		size_t next = active < chunkList.size() ? active + 1 : active;
+		size_t fit = next;
+		while (fit < chunkList.size() && chunkList[fit].size < bytes)
+			fit++;
+		if (fit == chunkList.size())
+		{
+			size_t size = max(chunkSize, bytes); //a request over the chunk size gets a chunk of its own
+			chunkList.insert(chunkList.begin() + next, Chunk{ static_cast<char*>(::operator new(size)), size });
+			fit = next;
+		}
+		active = fit;
+		offset = 0;
+		used = bytes;
+	}
+	counted(bytes);
+	if (timed)
+		allocateTime += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+	return chunkList[active].memory + offset;
+}
+
+void Arena::rewind(const Mark& mark)
+{
+	active = mark.chunk;
+	used = mark.used;
+	bytesInUse = mark.bytes;
+}
+
+Arena* Arena::current() { return currentArena; }
+void Arena::setEnabled(bool enabled) { arenasEnabled = enabled; }
+bool Arena::enabled() { return arenasEnabled; }
+
+ArenaScope::ArenaScope(Arena* arena)
+{
+	previous = currentArena;
+	currentArena = arena;
+}
+
+ArenaScope::~ArenaScope()
+{
+	currentArena = previous;
+}
@@ -0,0 +1,150 @@
+//bump allocation for the data of one solve, everything it handed out is given back at once when the solve ends
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+using std::vector;
+
+//chunks come from operator new and are only freed by the destructor, rewinding keeps them for reuse
+class Arena
+{
+	public:
+		explicit Arena(size_t chunkSize = 64 * 1024);
+		~Arena();
+		Arena(const Arena&) = delete;
+		Arena& operator=(const Arena&) = delete;
+
+		void* allocate(size_t bytes, size_t alignment) //alignment a power of two up to that of operator new
+		{
+			size_t start = (used + alignment - 1) & ~(alignment - 1);
+			if (timed || active >= chunkList.size() || start + bytes > chunkList[active].size)
+				return allocateSlow(bytes, alignment);
+			used = start + bytes;
+			counted(bytes);
+			return chunkList[active].memory + start;
+		}
+
+		struct Mark
+		{
+			size_t chunk;
+			size_t used;
+			size_t bytes;
+		};
+		Mark mark() const { return Mark{ active, used, bytesInUse }; }
+		void rewind(const Mark& mark); //take back everything allocated since mark
+
+		size_t allocations() const { return allocationCount; }
+		size_t peakBytes() const { return bytesPeak; } //most bytes handed out at once
+		size_t chunks() const { return chunkList.size(); }
+		long long nanoseconds() const { return allocateTime; } //spent in allocate, only measured while allocation timing is on
+
+		static Arena* current(); //the arena of the solve running on this thread, nullptr outside of one
+		static void setEnabled(bool enabled); //solves open an arena only while enabled, the default
+		static bool enabled();
+	private:
+		struct Chunk
+		{
+			char* memory;
+			size_t size;
+		};
+
+		void* allocateSlow(size_t bytes, size_t alignment); //the active chunk is full, or allocations are timed
+		void counted(size_t bytes)
+		{
+			allocationCount++;
+			bytesInUse += bytes;
+			if (bytesInUse > bytesPeak)
+				bytesPeak = bytesInUse;
+		}
+
+		size_t chunkSize;
+		bool timed; //allocation timing was on when the arena was made
+		vector<Chunk> chunkList;
+		size_t active = 0; //the chunk being filled, the ones after it are free
+		size_t used = 0; //bytes of the active chunk handed out
+		size_t bytesInUse = 0;
+		size_t bytesPeak = 0;
+		size_t allocationCount = 0;
+		long long allocateTime = 0;
+
+		friend class ArenaScope;
+};
+
+//makes arena the current one of this thread until the scope ends, nullptr makes containers use the heap again
+class ArenaScope
+{
+	public:
+		explicit ArenaScope(Arena* arena);
+		~ArenaScope();
+		ArenaScope(const ArenaScope&) = delete;
+		ArenaScope& operator=(const ArenaScope&) = delete;
+	private:
+		Arena* previous;
+};
+
+//scratch of one search node: what the current arena hands out while the frame lives is taken back when it ends. declare
+//it before the containers it covers, and never grow a container from outside the frame while it lives
+class ArenaFrame
+{
+	public:
+		ArenaFrame() : arena(Arena::current())
+		{
+			if (arena)
+				start = arena->mark();
+		}
+		~ArenaFrame()
+		{
+			if (arena)
+				arena->rewind(start);
+		}
+		ArenaFrame(const ArenaFrame&) = delete;
+		ArenaFrame& operator=(const ArenaFrame&) = delete;
+	private:
+		Arena* arena;
+		Arena::Mark start;
+};
+
+//takes the current arena when constructed and the heap outside of a solve. freeing arena memory does nothing, copies of a
+//container take the arena of the thread copying it, so data handed to other threads must not outlive the solve
+template <typename T>
+class ArenaAllocator
+{
+	public:
+		typedef T value_type;
+		typedef std::true_type propagate_on_container_move_assignment;
+		typedef std::true_type propagate_on_container_swap;
+
+		ArenaAllocator() : arena(Arena::current()) {}
+		explicit ArenaAllocator(Arena* arena) : arena(arena) {}
+		template <typename U>
+		ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.source()) {}
+
+		T* allocate(size_t count)
+		{
+			if (arena)
+				return static_cast<T*>(arena->allocate(count * sizeof(T), alignof(T)));
+			return static_cast<T*>(::operator new(count * sizeof(T)));
+		}
+		void deallocate(T* pointer, size_t)
+		{
+			if (!arena)
+				::operator delete(pointer);
+		}
+		ArenaAllocator select_on_container_copy_construction() const { return ArenaAllocator(); }
+
+		Arena* source() const { return arena; }
+		template <typename U>
+		bool operator==(const ArenaAllocator<U>& other) const { return arena == other.source(); }
+		template <typename U>
+		bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.source(); }
+	private:
+		Arena* arena;
+};
+
+template <typename T>
+using ArenaVector = vector<T, ArenaAllocator<T>>;
+
+#endif
@@ -0,0 +1,284 @@
+#include "Backjump.h"
+#include "CellKernel.h"
+#include "Arena.h"
+#include <algorithm>
+#include <climits>
+using namespace std;
+
+class LevelSet //decision levels as bits
+{
+	public:
+		void resize(int levels) { words.assign((levels + 63) / 64, 0); }
+		void add(int level) { words[level >> 6] |= uint64_t(1) << (level & 63); }
+		void erase(int level) { words[level >> 6] &= ~(uint64_t(1) << (level & 63)); }
+		bool contains(int level) const { return (words[level >> 6] >> (level & 63)) & 1; }
+		void clear() { fill(words.begin(), words.end(), 0); }
+		void merge(const LevelSet& other)
+		{
+			for (size_t i = 0; i < words.size(); i++)
+				words[i] |= other.words[i];
+		}
+
+		int count() const
+		{
+			int levels = 0;
+			for (uint64_t word : words)
+				levels += countBits(word);
+			return levels;
+		}
+
+		int highest() const //-1 when empty
+		{
+			for (int i = (int)words.size() - 1; i >= 0; i--)
+				if (words[i] != 0)
+				{
+					int bit = 63;
+					while (!((words[i] >> bit) & 1))
+						bit--;
+					return i * 64 + bit;
+				}
+			return -1;
+		}
+
+		template <typename Visit>
+		void forEach(Visit visit) const
+		{
+			for (size_t i = 0; i < words.size(); i++)
+				for (uint64_t word = words[i]; word != 0; word &= word - 1)
+					visit((int)i * 64 + countTrailingZeros(word));
+		}
+	private:
+		vector<uint64_t> words;
+};
+
+struct Decision //a line assigned one of its candidates
+{
+	int line; //rows first, then columns
+	int option;
+};
+
+class BackjumpSearch
+{
+	public:
+		BackjumpSearch(vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain, SearchStats& stats);
+		bool run() { return label(0) == solved; }
+	private:
+		static const int solved = -1;
+		static const int exhausted = -2; //no solution at all, or the node limit ran out
+
+		int label(int level); //solved, exhausted, or the level the search resumes at
+		bool forwardCheck(int level, int line, int option);
+		bool nogoodHit(int level, int line, int option);
+		void learn(const LevelSet& conflict);
+		void markPruned(int level, int line);
+		void undo(int level, size_t mark);
+
+		LineDomain& domain(int line) { return line < rows ? rowDomain[line] : columnDomain[line - rows]; }
+
+		vector<LineDomain>& rowDomain;
+		vector<LineDomain>& columnDomain;
+		SearchStats& stats;
+		int rows;
+		int lines;
+		vector<int> assigned; //per line, its option or -1
+		vector<int> lineLevel; //per line, the level that assigned it
+		vector<Decision> decisions; //per level
+		vector<LevelSet> prunedBy; //per line, the levels whose decisions removed its candidates
+		vector<vector<int>> prunedAt; //per level, the lines whose prunedBy holds it, so undoing a level visits only those
+		vector<LevelSet> conflicts; //per level, the earlier levels its failed candidates blame
+		vector<trailType> trail;
+		vector<vector<Decision>> nogoods; //assignments that cannot all hold, a ring of nogoodCapacity
+		long long nextNogood = 0;
+		vector<vector<int>> nogoodsOf; //per line, the nogoods with a member on it
+};
+
+BackjumpSearch::BackjumpSearch(vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain, SearchStats& stats)
+	: rowDomain(rowDomain), columnDomain(columnDomain), stats(stats)
+{
+	rows = rowDomain.size();
+	lines = rows + columnDomain.size();
+	assigned.assign(lines, -1);
+	lineLevel.assign(lines, -1);
+	decisions.resize(lines);
+	prunedBy.resize(lines);
+	prunedAt.resize(lines);
+	conflicts.resize(lines);
+	for (int i = 0; i < lines; i++)
+	{
+		prunedBy[i].resize(lines);
+		conflicts[i].resize(lines);
+	}
+	nogoodsOf.resize(lines);
+}
+
+int BackjumpSearch::label(int level)
+{
+	stats.nodes++;
+	if (stats.limitReached())
+		return exhausted;
+
+	int line = -1; //the smallest unassigned domain, columns win ties like backtrack
+	int smallest = INT_MAX;
+	for (int i = 0; i < lines; i++)
+		if (assigned[i] == -1 && (domain(i).size() < smallest || (domain(i).size() == smallest && i >= rows && line < rows)))
+		{
+			line = i;
+			smallest = domain(i).size();
+		}
+	if (line == -1) //every line assigned, forward checking kept them all consistent
+		return solved;
+
+	LineDomain& lineDomain = domain(line);
+	ArenaFrame frame; //the options of deeper levels are taken after these and given back first
+	ArenaVector<int> options;
+	for (int option = lineDomain.first(); option != -1; option = lineDomain.next(option))
+		options.push_back(option);
+
+	decisions[level] = Decision{ line, -1 };
+	lineLevel[line] = level;
+	conflicts[level].clear();
+	size_t mark = trail.size();
+	for (int option : options)
+	{
+		for (int other : options) //the line keeps only the assignment, removed by its own level
+			if (other != option)
+			{
+				lineDomain.remove(other);
+				trail.push_back(trailType{ line < rows ? line : line - rows, other, line < rows });
+			}
+		markPruned(level, line);
+		assigned[line] = option;
+		decisions[level].option = option;
+		stats.trailPeak = max(stats.trailPeak, trail.size());
+
+		if (!nogoodHit(level, line, option) && forwardCheck(level, line, option))
+		{
+			int resume = label(level + 1);
+			if (resume == solved)
+				return solved; //the trail is left in place, the domains hold the solution
+			if (resume == exhausted || resume < level) //this level is not to blame, it is undone on the way back
+			{
+				undo(level, mark);
+				assigned[line] = -1;
+				return resume;
+			}
+		}
+		undo(level, mark);
+	}
+	assigned[line] = -1;
+
+	//every candidate failed: blame whatever pruned the line or made its candidates fail
+	LevelSet conflict = conflicts[level];
+	conflict.merge(prunedBy[line]);
+	conflict.erase(level);
+	int back = conflict.highest();
+	if (back == -1) //nothing earlier to blame, there is no solution
+		return exhausted;
+
+	learn(conflict);
+	conflict.erase(back);
+	conflicts[back].merge(conflict);
+	if (back < level - 1)
+	{
+		stats.backjumps++;
+		stats.jumpedLevels += level - 1 - back;
+	}
+	return back;
+}
+
+bool BackjumpSearch::forwardCheck(int level, int line, int option)
+{
+	bool isRow = line < rows;
+	int index = isRow ? line : line - rows;
+	LineDomain& lineDomain = domain(line);
+	vector<LineDomain>& crossDomain = isRow ? columnDomain : rowDomain;
+	static thread_local vector<uint64_t> disagree;
+	for (int i = 0; i < crossDomain.size(); i++)
+	{
+		LineDomain& cross = crossDomain[i];
+		int crossLine = isRow ? rows + i : i;
+		cross.selectCell(index, !lineDomain.isFilled(option, i), disagree);
+		bool pruned = false;
+		for (int removed = LineDomain::next(disagree, -1); removed != -1; removed = LineDomain::next(disagree, removed))
+		{
+			cross.remove(removed);
+			trail.push_back(trailType{ i, removed, !isRow });
+			pruned = true;
+		}
+		if (pruned)
+			markPruned(level, crossLine);
+		if (cross.empty()) //every level that pruned it shares the blame
+		{
+			conflicts[level].merge(prunedBy[crossLine]);
+			return false;
+		}
+	}
+	return true;
+}
+
+bool BackjumpSearch::nogoodHit(int level, int line, int option)
+{
+	vector<int>& watched = nogoodsOf[line];
+	for (size_t i = 0; i < watched.size(); i++)
+	{
+		const vector<Decision>& nogood = nogoods[watched[i]];
+		bool holds = true;
+		for (int j = 0; j < nogood.size() && holds; j++)
+			holds = nogood[j].line == line ? nogood[j].option == option : assigned[nogood[j].line] == nogood[j].option;
+		if (holds)
+		{
+			stats.nogoodHits++;
+			for (const Decision& member : nogood)
+				if (member.line != line)
+					conflicts[level].add(lineLevel[member.line]);
+			return true;
+		}
+	}
+	return false;
+}
+
+void BackjumpSearch::learn(const LevelSet& conflict)
+{
+	if (conflict.count() > nogoodMaxSize)
+		return;
+	vector<Decision> nogood;
+	conflict.forEach([&](int level) { nogood.push_back(decisions[level]); });
+
+	int slot = nextNogood++ % nogoodCapacity;
+	if (slot >= nogoods.size())
+		nogoods.push_back(move(nogood));
+	else
+	{
+		for (const Decision& member : nogoods[slot]) //the oldest nogood is forgotten
+		{
+			vector<int>& watched = nogoodsOf[member.line];
+			watched.erase(find(watched.begin(), watched.end(), slot));
+		}
+		nogoods[slot] = move(nogood);
+	}
+	for (const Decision& member : nogoods[slot])
+		nogoodsOf[member.line].push_back(slot);
+	stats.nogoodsLearned++;
+}
+
+void BackjumpSearch::markPruned(int level, int line)
+{
+	if (prunedBy[line].contains(level))
+		return;
+	prunedBy[line].add(level);
+	prunedAt[level].push_back(line);
+}
+
+void BackjumpSearch::undo(int level, size_t mark)
+{
+	undoTrail(rowDomain, columnDomain, trail, mark);
+	for (int line : prunedAt[level]) //later levels were cleared when they were undone
+		prunedBy[line].erase(level);
+	prunedAt[level].clear();
+}
+
+bool backjump(vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain, SearchStats& stats)
+{
+	BackjumpSearch search(rowDomain, columnDomain, stats);
+	return search.run();
+}
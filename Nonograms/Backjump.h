@@ -0,0 +1,19 @@
+//forward checking over line assignments with conflict directed backjumping and learned nogoods
+#ifndef BACKJUMP_H
+#define BACKJUMP_H
+
+#include "Solver.h"
+#include <vector>
+using std::vector;
+
+const int nogoodCapacity = 4096; //learned nogoods kept at once, the oldest is replaced first
+const int nogoodMaxSize = 12; //conflicts blaming more decisions than this are too specific to be met again
+
+//the search of backtrack from domains with nothing assigned: the smallest unassigned domain is assigned next and its
+//crossing lines are pruned. every decision level keeps the earlier levels it depends on, the ones that pruned a line
+//that emptied or that pruned the line itself, so a line whose candidates all fail jumps straight back to the latest of
+//them and hands the rest over. that set of decisions is also learned as a nogood, refused whenever its last line is
+//assigned the same way again in a later branch. true once solved, every domain is then singular
+bool backjump(vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain, SearchStats& stats);
+
+#endif
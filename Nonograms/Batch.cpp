@@ -0,0 +1,281 @@
+#include "Batch.h"
+#include "ThreadPool.h"
+#include "LineCache.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+using namespace std;
+
+static bool isBlank(const string& line)
+{
+	return all_of(line.begin(), line.end(), [](char c) { return isspace((unsigned char)c); });
+}
+
+//every non digit separates labels, like the menu's label parsing
+static vector<int> parseLabels(const string& line)
+{
+	string spaced = line;
+	for (char& c : spaced)
+		if (!isdigit((unsigned char)c))
+			c = ' ';
+	istringstream words(spaced);
+	vector<int> labels;
+	int label;
+	while (words >> label)
+		labels.push_back(label);
+	return labels;
+}
+
+//the next non blank line holding a single positive number, 0 if there is none
+static int readSize(istream& in, bool& ended)
+{
+	string line;
+	ended = true;
+	while (getline(in, line))
+		if (!isBlank(line))
+		{
+			ended = false;
+			istringstream words(line);
+			int size;
+			string rest;
+			if (!(words >> size) || words >> rest || size <= 0)
+				return 0;
+			return size;
+		}
+	return 0;
+}
+
+static bool readLabelLines(istream& in, int count, vector<vector<int>>& labels)
+{
+	labels.clear(); //grown line by line, count comes from the input and a file too short for it is invalid, not a huge allocation
+	string line;
+	for (int i = 0; i < count; i++)
+	{
+		if (!getline(in, line))
+			return false;
+		labels.push_back(parseLabels(line)); //a blank line is a line with no filled cells
+	}
+	return true;
+}
+
+PuzzleRead readPuzzle(istream& in, Nonogram& n)
+{
+	bool ended;
+	int height = readSize(in, ended);
+	if (ended)
+		return PUZZLE_END;
+	vector<vector<int>> rows, columns;
+	if (height == 0 || !readLabelLines(in, height, rows))
+		return PUZZLE_INVALID;
+
+	int width = readSize(in, ended); //skips the blank line after the rows
+	if (width == 0 || !readLabelLines(in, width, columns))
+		return PUZZLE_INVALID;
+
+	n = Nonogram(move(rows), move(columns));
+	return PUZZLE_READ;
+}
+
+struct BatchEntry //one puzzle of the batch and its result line once solved
+{
+	string source;
+	bool valid;
+	Nonogram puzzle;
+	string result;
+	bool done = false;
+};
+
+static void readEntries(istream& in, const string& name, vector<BatchEntry>& entries)
+{
+	Nonogram n(vector<vector<int>>{}, vector<vector<int>>{}); //no labels, readPuzzle replaces it
+	for (int number = 1; ; number++)
+	{
+		PuzzleRead read = readPuzzle(in, n);
+		if (read == PUZZLE_END)
+			return;
+		entries.push_back({ name + ":" + to_string(number), read == PUZZLE_READ, n, "" });
+		if (read == PUZZLE_INVALID) //the stream is out of step with the format, nothing after this can be read
+			return;
+	}
+}
+
+static bool readInput(const string& input, vector<BatchEntry>& entries)
+{
+	if (input == "-")
+	{
+		readEntries(cin, "-", entries);
+		return true;
+	}
+
+	error_code error;
+	if (filesystem::is_directory(input, error))
+	{
+		vector<string> files;
+		for (const filesystem::directory_entry& file : filesystem::directory_iterator(input, error))
+			if (file.is_regular_file())
+				files.push_back(file.path().string());
+		sort(files.begin(), files.end()); //directory order is not stable across systems
+		bool opened = !error;
+		for (const string& file : files)
+			opened = readInput(file, entries) && opened;
+		return opened;
+	}
+
+	ifstream file(input);
+	if (!file)
+	{
+		cerr << "cannot open " << input << endl;
+		return false;
+	}
+	readEntries(file, input, entries);
+	return true;
+}
+
+static string solveEntry(BatchEntry& entry, int index, const BatchOptions& options, bool& solved)
+{
+	ostringstream line;
+	line << index << '\t' << entry.source << '\t';
+	solved = false;
+	if (!entry.valid)
+	{
+		line << "invalid\t0\t0\t-";
+		return line.str();
+	}
+
+	if (options.countLimit > 0)
+	{
+		SearchStats stats;
+		stats.probeLimit = defaultProbeLimit;
+		auto start = chrono::steady_clock::now();
+		long long count;
+		try
+		{
+			count = countSolutions(entry.puzzle, options.countLimit, stats, 1, options.lineBudget);
+		}
+		catch (const exception&)
+		{
+			line << "error\t" << chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() << '\t' << stats.nodes << "\t-";
+			return line.str();
+		}
+		solved = count == 1;
+		line << (count == 0 ? "none" : count == 1 ? "unique" : "multiple") << '\t'
+			<< chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() << '\t' << stats.nodes << '\t'
+			<< count << (count >= options.countLimit ? "+" : "");
+		return line.str();
+	}
+
+	SolveReport report;
+	ostream quiet(nullptr); //a stream without a buffer drops the progress messages
+	try
+	{
+		solved = solve(entry.puzzle, report, quiet, options.mode, options.lineBudget, 1) && entry.puzzle.isSolved();
+	}
+	catch (const exception&) //out of memory building domains, the other puzzles can still finish
+	{
+		line << "error\t" << report.ms << '\t' << report.nodes << "\t-";
+		return line.str();
+	}
+
+	line << (solved ? "solved" : "unsolved") << '\t' << report.ms << '\t' << report.nodes << '\t';
+	if (!solved)
+		line << '-';
+	for (int y = 0; solved && y < entry.puzzle.getHeight(); y++)
+	{
+		if (y > 0)
+			line << '/';
+		for (int x = 0; x < entry.puzzle.getWidth(); x++)
+			line << (entry.puzzle[x][y] == 'X' ? '#' : '.');
+	}
+	return line.str();
+}
+
+bool solveBatch(const vector<string>& inputs, const BatchOptions& options, ostream& out)
+{
+	vector<BatchEntry> entries;
+	bool allSolved = true;
+	for (const string& input : inputs)
+		allSolved = readInput(input, entries) && allSolved;
+
+	mutex outputLock;
+	size_t printed = 0; //entries before this are written, results after it wait for the ones in front
+	{
+		ThreadPool pool(options.threads);
+		for (size_t i = 0; i < entries.size(); i++)
+			pool.submit([&, i]()
+			{
+				bool solved;
+				string result = solveEntry(entries[i], i + 1, options, solved);
+
+				lock_guard<mutex> guard(outputLock);
+				entries[i].result = move(result);
+				entries[i].done = true;
+				allSolved = allSolved && solved;
+				for (; printed < entries.size() && entries[printed].done; printed++)
+					out << entries[printed].result << endl;
+			});
+		pool.wait();
+	}
+	return allSolved;
+}
+
+static int batchUsage()
+{
+	cerr << "usage: Nonograms batch [--threads N] [--mode lines|support|arc|sat] [--budget B] [--count LIMIT] [--no-cache] [--cache-stats]"
+		<< " [files or directories, - for stdin]" << endl;
+	return 2;
+}
+
+int batchMain(int argc, char* argv[])
+{
+	BatchOptions options;
+	options.threads = ThreadPool::defaultThreads();
+	vector<string> inputs;
+	bool cacheStats = false;
+	for (int i = 0; i < argc; i++)
+	{
+		string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--threads" && hasValue)
+			options.threads = max(1, atoi(argv[++i]));
+		else if (arg == "--budget" && hasValue)
+			options.lineBudget = atof(argv[++i]);
+		else if (arg == "--count" && hasValue)
+			options.countLimit = max(2LL, atoll(argv[++i])); //a limit of 1 could not tell unique from multiple
+		else if (arg == "--no-cache")
+			LineCache::shared().setEnabled(false);
+		else if (arg == "--cache-stats")
+			cacheStats = true;
+		else if (arg == "--mode" && hasValue)
+		{
+			string mode = argv[++i];
+			if (mode == "lines")
+				options.mode = LINE_SOLVING;
+			else if (mode == "support")
+				options.mode = SUPPORT_COUNTING;
+			else if (mode == "arc")
+				options.mode = ARC_CONSISTENCY;
+			else if (mode == "sat")
+				options.mode = SAT_SOLVING;
+			else
+				return batchUsage();
+		}
+		else if (arg.size() > 1 && arg[0] == '-')
+			return batchUsage();
+		else
+			inputs.push_back(arg);
+	}
+	if (inputs.empty())
+		inputs.push_back("-");
+
+	bool allSolved = solveBatch(inputs, options, cout);
+	if (cacheStats) //stderr, so the result lines stay machine readable
+	{
+		LineCacheStats stats = LineCache::shared().stats();
+		cerr << "line cache: " << stats.hits << " hits, " << stats.misses << " misses, " << stats.evictions << " evictions" << endl;
+	}
+	return allSolved ? 0 : 1;
+}
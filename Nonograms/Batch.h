@@ -0,0 +1,43 @@
+//solving many puzzles without the interactive menu, one result line per puzzle
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "Nonogram.h"
+#include "Solver.h"
+#include <istream>
+#include <string>
+#include <vector>
+using std::istream;
+using std::string;
+using std::vector;
+
+enum PuzzleRead //what readPuzzle found
+{
+	PUZZLE_READ,
+	PUZZLE_END, //only blank lines were left
+	PUZZLE_INVALID //the labels could not be parsed, the rest of the stream cannot be trusted
+};
+
+//the puzzle.txt format: the height, a line of row labels per row, a blank line, the width and a line of column labels
+//per column. blank lines before a puzzle are skipped, so puzzle files can simply be concatenated
+PuzzleRead readPuzzle(istream& in, Nonogram& n);
+
+struct BatchOptions
+{
+	int threads = 1; //puzzles solved at once, each solve stays on one thread
+	Propagation mode = LINE_SOLVING;
+	double lineBudget = defaultLineBudget;
+	long long countLimit = 0; //0 solves, otherwise counts solutions up to this (at least 2) instead of keeping one
+};
+
+//solves every puzzle in the inputs, each a file, a directory of puzzle files or "-" for stdin. writes one tab separated
+//line per puzzle to out in input order: index, source, status, ms, nodes and the solution rows ('#' filled, '.' empty)
+//joined by '/'. false if any puzzle was invalid or unsolved. when counting, the status is unique, multiple or none, the
+//last column is how many solutions were found, ending in '+' if the limit stopped the count, and false means not unique
+bool solveBatch(const vector<string>& inputs, const BatchOptions& options, ostream& out);
+
+//the command line: batch [--threads N] [--mode lines|support|arc|sat] [--budget B] [--count LIMIT] [--no-cache] [--cache-stats]
+//[inputs...], stdin without inputs
+int batchMain(int argc, char* argv[]);
+
+#endif
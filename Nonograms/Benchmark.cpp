@@ -0,0 +1,1339 @@
+#include "Benchmark.h"
+#include "Solver.h"
+#include "SetSolver.h"
+#include "MemoryTracker.h"
+#include "LineSolver.h"
+#include "SupportCounter.h"
+#include "ParallelSearch.h"
+#include "ThreadPool.h"
+#include "CellKernel.h"
+#include "LineCache.h"
+#include "PlacementEnumerator.h"
+#include "SmallSolver.h"
+#include "PuzzleGenerator.h"
+#include "Backjump.h"
+#include "SatSolver.h"
+#include "Portfolio.h"
+#include "Arena.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <mutex>
+using namespace std;
+using chrono::high_resolution_clock;
+
+struct PhaseResult //what one implementation cost on one puzzle
+{
+	double optionsMs = 0;
+	double arcsMs = 0;
+	double searchMs = 0;
+	size_t peakBytes = 0; //peak heap above what was in use before the solve
+	bool solved = false;
+};
+
+static double millisecondsSince(high_resolution_clock::time_point start)
+{
+	return chrono::duration<double, milli>(high_resolution_clock::now() - start).count();
+}
+
+static PhaseResult runPacked(const Nonogram& n)
+{
+	PhaseResult result;
+	size_t baseline = currentMemory();
+	resetPeakMemory();
+	{
+		auto start = high_resolution_clock::now();
+		vector<LineDomain> rowDomain = getRowOptions(n);
+		vector<LineDomain> columnDomain = getColumnOptions(n);
+		result.optionsMs = millisecondsSince(start);
+
+		start = high_resolution_clock::now();
+		bool consistent = arcConsistency(rowDomain, columnDomain);
+		result.arcsMs = millisecondsSince(start);
+
+		if (consistent)
+		{
+			vector<bool> rowAssign(n.getHeight(), false);
+			vector<bool> columnAssign(n.getWidth(), false);
+			start = high_resolution_clock::now();
+			result.solved = backtrack(rowDomain, columnDomain, rowAssign, columnAssign);
+			result.searchMs = millisecondsSince(start);
+		}
+	}
+	result.peakBytes = peakMemory() - baseline;
+	return result;
+}
+
+static PhaseResult runSets(const Nonogram& n)
+{
+	PhaseResult result;
+	size_t baseline = currentMemory();
+	resetPeakMemory();
+	{
+		auto start = high_resolution_clock::now();
+		vector<set<vector<char>>> rowDomain = setSolver::getRowOptions(n);
+		vector<set<vector<char>>> columnDomain = setSolver::getColumnOptions(n);
+		result.optionsMs = millisecondsSince(start);
+
+		start = high_resolution_clock::now();
+		bool consistent = setSolver::arcConsistency(rowDomain, columnDomain);
+		result.arcsMs = millisecondsSince(start);
+
+		if (consistent)
+		{
+			vector<bool> rowAssign(n.getHeight(), false);
+			vector<bool> columnAssign(n.getWidth(), false);
+			start = high_resolution_clock::now();
+			setSolver::backtrack(rowDomain, columnDomain, rowAssign, columnAssign);
+			result.searchMs = millisecondsSince(start);
+			result.solved = setSolver::domainsAreSingular(rowDomain, columnDomain, rowAssign, columnAssign);
+		}
+	}
+	result.peakBytes = peakMemory() - baseline;
+	return result;
+}
+
+static void printResult(ostream& out, const string& name, int size, const PhaseResult& total, int solved, int puzzles)
+{
+	out << left << setw(8) << name << right << setw(4) << size << 'x' << left << setw(4) << size << right << fixed << setprecision(2)
+		<< setw(12) << total.optionsMs << setw(12) << total.arcsMs << setw(12) << total.searchMs
+		<< setw(14) << total.peakBytes / 1024 << setw(6) << solved << '/' << puzzles << '\n';
+}
+
+void benchmarkDomains(ostream& out)
+{
+	const int sizes[] = { 10, 12, 15 }; //without propagation during the search some 20x20 puzzles run for minutes
+	const int puzzles = 5; //puzzles per size, the totals are summed over them
+	const unsigned seed = 2020;
+
+	out << left << setw(8) << "domain" << setw(9) << " size" << right << setw(12) << "options ms" << setw(12) << "arcs ms"
+		<< setw(12) << "search ms" << setw(14) << "peak KiB" << setw(8) << "solved" << '\n';
+	for (int size : sizes)
+	{
+		PhaseResult setTotal, packedTotal;
+		int setSolved = 0, packedSolved = 0;
+		PuzzleGenerator generator(seed + size);
+		for (int i = 0; i < puzzles; i++)
+		{
+			Nonogram n = generator.puzzle(size, size);
+
+			PhaseResult sets = runSets(n);
+			setTotal.optionsMs += sets.optionsMs;
+			setTotal.arcsMs += sets.arcsMs;
+			setTotal.searchMs += sets.searchMs;
+			setTotal.peakBytes = max(setTotal.peakBytes, sets.peakBytes); //worst puzzle
+			setSolved += sets.solved;
+
+			PhaseResult packed = runPacked(n);
+			packedTotal.optionsMs += packed.optionsMs;
+			packedTotal.arcsMs += packed.arcsMs;
+			packedTotal.searchMs += packed.searchMs;
+			packedTotal.peakBytes = max(packedTotal.peakBytes, packed.peakBytes);
+			packedSolved += packed.solved;
+		}
+		printResult(out, "set", size, setTotal, setSolved, puzzles);
+		printResult(out, "packed", size, packedTotal, packedSolved, puzzles);
+		out.flush(); //each size can take a while, show the rows as they finish
+	}
+	out.unsetf(ios::fixed);
+}
+
+static size_t liveCandidates(const vector<LineDomain>& domains)
+{
+	size_t count = 0;
+	for (const LineDomain& domain : domains)
+		count += domain.size();
+	return count;
+}
+
+void benchmarkPropagation(ostream& out)
+{
+	const int sizes[] = { 10, 15, 20 };
+	const int puzzles = 5;
+	const unsigned seed = 2020;
+
+	out << left << setw(9) << " size" << right << setw(12) << "candidates" << setw(12) << "arc ms" << setw(12) << "revisions"
+		<< setw(12) << "arc peak" << setw(12) << "support ms" << setw(10) << "speedup" << setw(8) << "agree" << '\n';
+	for (int size : sizes)
+	{
+		double arcMs = 0, supportMs = 0;
+		size_t candidates = 0;
+		int agree = 0; //puzzles where both reached the same domains
+		PropagationStats arcStats;
+		PuzzleGenerator generator(seed + size);
+		for (int i = 0; i < puzzles; i++)
+		{
+			Nonogram n = generator.puzzle(size, size);
+			vector<LineDomain> rowDomain = getRowOptions(n);
+			vector<LineDomain> columnDomain = getColumnOptions(n);
+			candidates += liveCandidates(rowDomain) + liveCandidates(columnDomain);
+
+			vector<LineDomain> arcRows = rowDomain, arcColumns = columnDomain; //copies only duplicate the live masks
+			auto start = high_resolution_clock::now();
+			bool arcConsistent = arcConsistency(arcRows, arcColumns, arcStats);
+			arcMs += millisecondsSince(start);
+
+			start = high_resolution_clock::now();
+			bool supportConsistent = supportConsistency(rowDomain, columnDomain);
+			supportMs += millisecondsSince(start);
+
+			bool same = arcConsistent == supportConsistent;
+			for (int line = 0; same && line < size; line++)
+				for (int option = 0; option < rowDomain[line].totalSize(); option++)
+					same = same && arcRows[line].isLive(option) == rowDomain[line].isLive(option);
+			for (int line = 0; same && line < size; line++)
+				for (int option = 0; option < columnDomain[line].totalSize(); option++)
+					same = same && arcColumns[line].isLive(option) == columnDomain[line].isLive(option);
+			agree += same;
+		}
+		out << right << setw(4) << size << 'x' << left << setw(4) << size << right << fixed << setprecision(2)
+			<< setw(12) << candidates << setw(12) << arcMs << setw(12) << arcStats.revisions << setw(12) << arcStats.queuePeak << setw(12) << supportMs
+			<< setw(9) << arcMs / supportMs << 'x' << setw(6) << agree << '/' << puzzles << '\n';
+		out.flush();
+	}
+	out.unsetf(ios::fixed);
+}
+
+void benchmarkLineSolver(ostream& out)
+{
+	const int sizes[] = { 10, 15, 20, 40, 60, 100 };
+	const int domainLimit = 20; //past this enumerating the domains takes too long to be worth timing
+	const int puzzles = 5;
+	const int fillPercent = 70;
+	const unsigned seed = 2020;
+
+	out << left << setw(9) << " size" << right << setw(14) << "domains ms" << setw(12) << "lines ms" << setw(8) << "solved" << '\n';
+	for (int size : sizes)
+	{
+		double domainMs = 0, lineMs = 0;
+		int solved = 0;
+		PuzzleGenerator generator(seed + size);
+		for (int i = 0; i < puzzles; i++)
+		{
+			Nonogram n = generator.puzzle(size, size, fillPercent / 100.0);
+			if (size <= domainLimit)
+			{
+				auto start = high_resolution_clock::now();
+				vector<LineDomain> rowDomain = getRowOptions(n);
+				vector<LineDomain> columnDomain = getColumnOptions(n);
+				vector<bool> rowAssign(n.getHeight(), false);
+				vector<bool> columnAssign(n.getWidth(), false);
+				if (supportConsistency(rowDomain, columnDomain))
+					backtrack(rowDomain, columnDomain, rowAssign, columnAssign);
+				domainMs += millisecondsSince(start);
+			}
+
+			auto start = high_resolution_clock::now();
+			solved += solveByLines(n) && n.isSolved();
+			lineMs += millisecondsSince(start);
+		}
+		out << right << setw(4) << size << 'x' << left << setw(4) << size << right << fixed << setprecision(2);
+		if (size <= domainLimit)
+			out << setw(14) << domainMs;
+		else
+			out << setw(14) << '-';
+		out << setw(12) << lineMs << setw(6) << solved << '/' << puzzles << '\n';
+		out.flush();
+	}
+	out.unsetf(ios::fixed);
+}
+
+struct SearchResult //what one search cost, measured after both domains reach the same arc consistent fixpoint
+{
+	long long nodes = 0;
+	size_t allocations = 0;
+	size_t peakBytes = 0;
+	double ms = 0;
+	int solved = 0;
+
+	void add(const SearchResult& other)
+	{
+		nodes += other.nodes;
+		allocations += other.allocations;
+		peakBytes = max(peakBytes, other.peakBytes); //worst puzzle
+		ms += other.ms;
+		solved += other.solved;
+	}
+};
+
+static SearchResult searchSets(const Nonogram& n)
+{
+	SearchResult result;
+	vector<set<vector<char>>> rowDomain = setSolver::getRowOptions(n);
+	vector<set<vector<char>>> columnDomain = setSolver::getColumnOptions(n);
+	if (!setSolver::arcConsistency(rowDomain, columnDomain))
+		return result;
+
+	vector<bool> rowAssign(n.getHeight(), false);
+	vector<bool> columnAssign(n.getWidth(), false);
+	size_t baseline = currentMemory();
+	size_t allocations = allocationCount();
+	setSolver::backtrackNodes = 0;
+	resetPeakMemory();
+	auto start = high_resolution_clock::now();
+	setSolver::backtrack(rowDomain, columnDomain, rowAssign, columnAssign);
+	result.ms = millisecondsSince(start);
+	result.peakBytes = peakMemory() - baseline;
+	result.allocations = allocationCount() - allocations;
+	result.nodes = setSolver::backtrackNodes;
+	result.solved = setSolver::domainsAreSingular(rowDomain, columnDomain, rowAssign, columnAssign);
+	return result;
+}
+
+static SearchResult searchTrail(const Nonogram& n)
+{
+	SearchResult result;
+	vector<LineDomain> rowDomain = getRowOptions(n);
+	vector<LineDomain> columnDomain = getColumnOptions(n);
+	if (!supportConsistency(rowDomain, columnDomain))
+		return result;
+
+	vector<bool> rowAssign(n.getHeight(), false);
+	vector<bool> columnAssign(n.getWidth(), false);
+	vector<trailType> trail;
+	SearchStats stats;
+	size_t baseline = currentMemory();
+	size_t allocations = allocationCount();
+	resetPeakMemory();
+	auto start = high_resolution_clock::now();
+	result.solved = backtrack(rowDomain, columnDomain, rowAssign, columnAssign, trail, stats);
+	result.ms = millisecondsSince(start);
+	result.peakBytes = peakMemory() - baseline;
+	result.allocations = allocationCount() - allocations;
+	result.nodes = stats.nodes;
+	return result;
+}
+
+static void printSearch(ostream& out, const string& name, int size, const SearchResult& total, int puzzles)
+{
+	out << left << setw(8) << name << right << setw(4) << size << 'x' << left << setw(4) << size << right << fixed << setprecision(2)
+		<< setw(10) << total.nodes << setw(14) << total.allocations << setw(12) << total.peakBytes / 1024
+		<< setw(12) << total.ms << setw(6) << total.solved << '/' << puzzles << '\n';
+}
+
+void benchmarkSearch(ostream& out)
+{
+	const int sizes[] = { 10, 12, 15 }; //without propagation during the search some 20x20 puzzles run for minutes
+	const int puzzles = 5;
+	const unsigned seed = 2020;
+
+	out << left << setw(8) << "search" << setw(9) << " size" << right << setw(10) << "nodes" << setw(14) << "allocations"
+		<< setw(12) << "peak KiB" << setw(12) << "search ms" << setw(8) << "solved" << '\n';
+	for (int size : sizes)
+	{
+		SearchResult copyTotal, trailTotal;
+		PuzzleGenerator generator(seed + size);
+		for (int i = 0; i < puzzles; i++)
+		{
+			Nonogram n = generator.puzzle(size, size);
+			copyTotal.add(searchSets(n));
+			trailTotal.add(searchTrail(n));
+		}
+		printSearch(out, "copy", size, copyTotal, puzzles);
+		printSearch(out, "trail", size, trailTotal, puzzles);
+		out.flush();
+	}
+	out.unsetf(ios::fixed);
+}
+
+void benchmarkMac(ostream& out)
+{
+	const int sizes[] = { 15, 20, 25 };
+	const int puzzles = 4;
+	const long long nodeLimit = 5000; //some random puzzles run for minutes either way, a '>' marks searches that gave up
+	const unsigned seed = 2020;
+
+	out << left << setw(9) << " size" << right << setw(8) << "puzzle" << setw(12) << "fc nodes" << setw(12) << "fc ms"
+		<< setw(12) << "mac nodes" << setw(12) << "mac ms" << '\n';
+	for (int size : sizes)
+	{
+		PuzzleGenerator generator(seed + size);
+		for (int i = 0; i < puzzles; i++)
+		{
+			Nonogram n = generator.puzzle(size, size);
+			vector<bool> rowLazy, columnLazy;
+			vector<LineDomain> rowDomain = getRowOptions(n, defaultLineBudget, rowLazy);
+			vector<LineDomain> columnDomain = getColumnOptions(n, defaultLineBudget, columnLazy);
+			if (!supportConsistency(rowDomain, columnDomain))
+				continue;
+
+			//both searches start from the same consistent domains, copies only duplicate the live masks
+			vector<LineDomain> fcRows = rowDomain, fcColumns = columnDomain;
+			vector<bool> rowAssign(size, false), columnAssign(size, false);
+			vector<trailType> trail;
+			SearchStats fcStats;
+			fcStats.nodeLimit = nodeLimit;
+			auto start = high_resolution_clock::now();
+			backtrack(fcRows, fcColumns, rowAssign, columnAssign, trail, fcStats);
+			double fcMs = millisecondsSince(start);
+
+			SupportCounter counter(rowDomain, columnDomain);
+			SearchStats macStats;
+			macStats.nodeLimit = nodeLimit;
+			start = high_resolution_clock::now();
+			macBacktrack(counter, macStats);
+			double macMs = millisecondsSince(start);
+
+			out << right << setw(4) << size << 'x' << left << setw(4) << size << right << setw(8) << i << fixed << setprecision(2)
+				<< setw(12) << (fcStats.limitReached() ? ">" + to_string(fcStats.nodes) : to_string(fcStats.nodes)) << setw(12) << fcMs
+				<< setw(12) << (macStats.limitReached() ? ">" + to_string(macStats.nodes) : to_string(macStats.nodes)) << setw(12) << macMs << '\n';
+			out.flush();
+		}
+	}
+	out.unsetf(ios::fixed);
+}
+
+void benchmarkParallel(ostream& out)
+{
+	const int sizes[] = { 20, 25 };
+	const int puzzles = 4;
+	const long long nodeLimit = 20000; //puzzles the sequential search cannot solve within this are left out of the timings
+	const unsigned seed = 2020;
+
+	vector<int> threadCounts = { 1, 2, 4 };
+	for (int threads = 8; threads <= ThreadPool::defaultThreads(); threads *= 2)
+		threadCounts.push_back(threads);
+
+	vector<Nonogram> corpus;
+	for (int size : sizes)
+	{
+		PuzzleGenerator generator(seed + size);
+		for (int i = 0; i < puzzles; i++)
+			corpus.push_back(generator.puzzle(size, size));
+	}
+
+	out << "hardware threads: " << ThreadPool::defaultThreads() << '\n';
+	out << right << setw(8) << "threads" << setw(12) << "nodes" << setw(12) << "search ms" << setw(10) << "speedup" << setw(8) << "solved" << '\n';
+	double singleMs = 0;
+	vector<bool> timed(corpus.size(), true);
+	for (int threads : threadCounts)
+	{
+		long long nodes = 0;
+		double ms = 0;
+		int solved = 0, counted = 0;
+		for (int i = 0; i < corpus.size(); i++)
+		{
+			if (!timed[i])
+				continue;
+			vector<bool> rowLazy, columnLazy; //consistent domains are rebuilt per run, the search changes them
+			vector<LineDomain> rowDomain = getRowOptions(corpus[i], defaultLineBudget, rowLazy);
+			vector<LineDomain> columnDomain = getColumnOptions(corpus[i], defaultLineBudget, columnLazy);
+			if (!supportConsistency(rowDomain, columnDomain))
+				continue;
+
+			SearchStats stats;
+			stats.nodeLimit = nodeLimit; //in parallel every task may use what is left, so this is only a safety net
+			auto start = high_resolution_clock::now();
+			bool found;
+			if (threads == 1) //the sequential search solve() uses by default
+			{
+				SupportCounter counter(rowDomain, columnDomain);
+				found = macBacktrack(counter, stats);
+				timed[i] = found;
+			}
+			else
+				found = parallelSearch(rowDomain, columnDomain, threads, stats);
+			if (!timed[i])
+				continue;
+			ms += millisecondsSince(start);
+			nodes += stats.nodes;
+			solved += found;
+			counted++;
+		}
+		if (threads == 1)
+			singleMs = ms;
+		out << setw(8) << threads << setw(12) << nodes << fixed << setprecision(2) << setw(12) << ms
+			<< setw(9) << singleMs / ms << 'x' << setw(6) << solved << '/' << counted << '\n';
+		out.flush();
+	}
+	out.unsetf(ios::fixed);
+}
+
+struct PhaseSample //one phase of one puzzle
+{
+	double ms = 0;
+	size_t peakBytes = 0; //peak heap during the phase above what was in use before the puzzle
+};
+
+//nearest rank percentile, p in [0, 100]
+static double percentile(vector<double> values, double p)
+{
+	if (values.empty())
+		return 0;
+	sort(values.begin(), values.end());
+	size_t rank = (size_t)ceil(p / 100 * values.size());
+	return values[rank == 0 ? 0 : rank - 1];
+}
+
+static void printPhase(ostream& out, int size, int fillPercent, unsigned seed, const string& phase, const vector<PhaseSample>& samples, int solved, int limited)
+{
+	vector<double> ms, peakKib;
+	for (const PhaseSample& sample : samples)
+	{
+		ms.push_back(sample.ms);
+		peakKib.push_back(sample.peakBytes / 1024.0);
+	}
+	double meanMs = 0;
+	for (double time : ms)
+		meanMs += time;
+	meanMs /= max<size_t>(1, ms.size());
+
+	out << size << ',' << fillPercent << ',' << seed << ',' << phase << ',' << samples.size() << ',' << solved << ',' << limited
+		<< fixed << setprecision(3) << ',' << percentile(ms, 50) << ',' << percentile(ms, 90) << ',' << percentile(ms, 99)
+		<< ',' << percentile(ms, 100) << ',' << meanMs << setprecision(1);
+	if (memoryTracked())
+		out << ',' << percentile(peakKib, 50) << ',' << percentile(peakKib, 100) << '\n';
+	else
+		out << ",,\n"; //left empty, a build without NONOGRAMS_TRACK_MEMORY has no heap figures to report
+	out.unsetf(ios::fixed);
+}
+
+void benchmarkSuite(ostream& out)
+{
+	const int sizes[] = { 10, 15, 20, 25 };
+	const int fillPercents[] = { 50, 60, 70 };
+	const int puzzles = 10; //per size and density
+	const long long nodeLimit = 2000; //searches that give up count as limited, their time is still in the percentiles
+	const unsigned baseSeed = 2020;
+
+	out << "size,fill,seed,phase,puzzles,solved,limited,p50_ms,p90_ms,p99_ms,max_ms,mean_ms,p50_peak_kib,max_peak_kib\n";
+	for (int size : sizes)
+		for (int fillPercent : fillPercents)
+		{
+			unsigned seed = baseSeed + size * 100 + fillPercent; //each corpus can be rebuilt on its own
+			PuzzleGenerator generator(seed);
+			vector<PhaseSample> options, propagation, search, total, lines;
+			int solved = 0, limited = 0, lineSolved = 0, lineLimited = 0;
+			for (int i = 0; i < puzzles; i++)
+			{
+				Nonogram n = generator.puzzle(size, size, fillPercent / 100.0);
+				PhaseSample optionSample, propagationSample, searchSample;
+				size_t baseline = currentMemory();
+
+				//the phases of the domain path of solve() with support counting, timed one by one. the line solving default
+				//has no phases of its own and gets a row of its own below
+				resetPeakMemory();
+				auto start = high_resolution_clock::now();
+				vector<bool> rowLazy, columnLazy;
+				vector<LineDomain> rowDomain = getRowOptions(n, defaultLineBudget, rowLazy);
+				vector<LineDomain> columnDomain = getColumnOptions(n, defaultLineBudget, columnLazy);
+				optionSample.ms = millisecondsSince(start);
+				optionSample.peakBytes = peakMemory() - baseline;
+
+				resetPeakMemory();
+				start = high_resolution_clock::now();
+				vector<vector<char>> grid(size, vector<char>(size, ' '));
+				bool consistent = boundedConsistency(n, rowDomain, columnDomain, rowLazy, columnLazy, grid, defaultLineBudget);
+				bool lazy = find(rowLazy.begin(), rowLazy.end(), true) != rowLazy.end() || find(columnLazy.begin(), columnLazy.end(), true) != columnLazy.end();
+				if (consistent && !lazy)
+					consistent = propagate(rowDomain, columnDomain, SUPPORT_COUNTING);
+				propagationSample.ms = millisecondsSince(start);
+				propagationSample.peakBytes = peakMemory() - baseline;
+
+				resetPeakMemory();
+				start = high_resolution_clock::now();
+				SearchStats stats;
+				stats.nodeLimit = nodeLimit;
+				bool found = false;
+				if (consistent && lazy)
+					found = lineSearch(n, grid, stats);
+				else if (consistent)
+				{
+					SupportCounter counter(rowDomain, columnDomain);
+					found = counter.propagate() && macBacktrack(counter, stats);
+				}
+				searchSample.ms = millisecondsSince(start);
+				searchSample.peakBytes = peakMemory() - baseline;
+
+				solved += found;
+				limited += !found && stats.limitReached();
+				options.push_back(optionSample);
+				propagation.push_back(propagationSample);
+				search.push_back(searchSample);
+				total.push_back({ optionSample.ms + propagationSample.ms + searchSample.ms,
+					max(optionSample.peakBytes, max(propagationSample.peakBytes, searchSample.peakBytes)) });
+
+				PhaseSample lineSample; //what solve() does with LINE_SOLVING, without its log
+				resetPeakMemory();
+				start = high_resolution_clock::now();
+				Nonogram attempt = n;
+				SearchStats lineStats;
+				lineStats.nodeLimit = nodeLimit;
+				lineStats.probeLimit = defaultProbeLimit;
+				bool lineFound = hasSmallSolver(size, size) ? solveSmall(attempt, lineStats) : solveByLines(attempt, lineStats);
+				lineSample.ms = millisecondsSince(start);
+				lineSample.peakBytes = peakMemory() - baseline;
+				lineSolved += lineFound;
+				lineLimited += !lineFound && lineStats.limitReached();
+				lines.push_back(lineSample);
+			}
+			printPhase(out, size, fillPercent, seed, "options", options, solved, limited);
+			printPhase(out, size, fillPercent, seed, "propagate", propagation, solved, limited);
+			printPhase(out, size, fillPercent, seed, "search", search, solved, limited);
+			printPhase(out, size, fillPercent, seed, "total", total, solved, limited);
+			printPhase(out, size, fillPercent, seed, "lines", lines, lineSolved, lineLimited);
+			out.flush();
+		}
+}
+
+void benchmarkGenerator(ostream& out)
+{
+	const int sizes[] = { 5, 10, 25, 50, 100 };
+	const int fillPercents[] = { 30, 50, 70 };
+	const double seconds = 0.2; //per size and density
+
+	out << left << setw(9) << " size" << right << setw(8) << "fill" << setw(16) << "puzzles/s" << setw(16) << "labeled/s" << '\n';
+	for (int size : sizes)
+		for (int fillPercent : fillPercents)
+		{
+			PuzzleGenerator generator(2020);
+			vector<uint64_t> cells;
+			vector<vector<int>> rows, columns;
+			long long labeled = 0;
+			size_t labels = 0; //keeps the work from being optimized away
+			auto start = high_resolution_clock::now();
+			while (millisecondsSince(start) < seconds * 1000)
+				for (int i = 0; i < 100; i++, labeled++) //the storage is reused, so this is the generator alone
+				{
+					generator.generate(size, size, fillPercent / 100.0, cells, rows, columns);
+					labels += rows[0].size();
+				}
+			double labeledRate = labeled / (millisecondsSince(start) / 1000);
+
+			long long built = 0;
+			start = high_resolution_clock::now();
+			while (millisecondsSince(start) < seconds * 1000)
+				for (int i = 0; i < 10; i++, built++)
+					labels += generator.puzzle(size, size, fillPercent / 100.0).getWidth();
+			double builtRate = built / (millisecondsSince(start) / 1000);
+
+			out << right << setw(4) << size << 'x' << left << setw(4) << size << right << setw(7) << fillPercent << '%' << fixed << setprecision(0)
+				<< setw(16) << builtRate << setw(16) << labeledRate << (labels == 0 ? " " : "") << '\n';
+			out.flush();
+		}
+	out.unsetf(ios::fixed);
+}
+
+void benchmarkSetup(ostream& out)
+{
+	const int sizes[] = { 10, 20, 40, 60 };
+	const int fillPercent = 60;
+	const unsigned seed = 2020;
+
+	if (!memoryTracked())
+	{
+		out << "allocation counts need a build with NONOGRAMS_TRACK_MEMORY" << '\n';
+		return;
+	}
+	out << left << setw(9) << " size" << right << setw(14) << "build allocs" << setw(14) << "label allocs"
+		<< setw(16) << "option allocs" << setw(12) << "per line" << '\n';
+	for (int size : sizes)
+	{
+		PuzzleGenerator generator(seed + size);
+		vector<uint64_t> cells;
+		vector<vector<int>> rows, columns;
+		generator.generate(size, size, fillPercent / 100.0, cells, rows, columns);
+
+		size_t allocations = allocationCount();
+		Nonogram n(move(rows), move(columns)); //should only allocate the grid
+		size_t buildAllocations = allocationCount() - allocations;
+
+		//every accessor the setup functions use, once per line, should read the labels in place
+		allocations = allocationCount();
+		long long check = 0;
+		for (int row = 0; row < n.getHeight(); row++)
+		{
+			const vector<int>& clue = n.getRow(row);
+			check += getSum(clue, getWidth(clue), n.getWidth()) + countLineOptions(clue, n.getWidth());
+		}
+		for (int column = 0; column < n.getWidth(); column++)
+		{
+			const vector<int>& clue = n.getColumn(column);
+			check += getSum(clue, getWidth(clue), n.getHeight()) + countLineOptions(clue, n.getHeight());
+		}
+		size_t labelAllocations = allocationCount() - allocations;
+
+		allocations = allocationCount();
+		vector<bool> rowLazy, columnLazy;
+		vector<LineDomain> rowDomain = getRowOptions(n, defaultLineBudget, rowLazy);
+		vector<LineDomain> columnDomain = getColumnOptions(n, defaultLineBudget, columnLazy);
+		size_t optionAllocations = allocationCount() - allocations;
+
+		out << right << setw(4) << size << 'x' << left << setw(4) << size << right << setw(14) << buildAllocations
+			<< setw(14) << labelAllocations << setw(16) << optionAllocations << fixed << setprecision(1)
+			<< setw(12) << (double)optionAllocations / (2 * size) << (check < 0 ? " " : "") << '\n';
+		out.flush();
+	}
+	out.unsetf(ios::fixed);
+}
+
+void benchmarkVerify(ostream& out)
+{
+	const int sizes[] = { 25, 50, 100, 200 };
+	const int moves = 20000;
+	const unsigned seed = 2020;
+
+	out << left << setw(11) << " size" << right << setw(14) << "move ns" << setw(14) << "full ns" << setw(14) << "allocations" << '\n';
+	for (int size : sizes)
+	{
+		Nonogram n(size, size, seed + size, 0.6); //holds its solution, so every check has to read all the way through
+		vector<uint8_t> packed = n.packCells();
+		n.isSolved();
+
+		//a move and its undo on the solved board, like a player trying a cell
+		PuzzleGenerator generator(seed);
+		size_t allocations = allocationCount();
+		int solved = 0;
+		auto start = high_resolution_clock::now();
+		for (int i = 0; i < moves; i++)
+		{
+			int x = (int)(generator.next() % size), y = (int)(generator.next() % size);
+			char mark = n[x][y];
+			n[x][y] = mark == 'X' ? '-' : 'X';
+			solved += n.isSolved();
+			n[x][y] = mark;
+			solved += n.isSolved();
+		}
+		double moveNs = millisecondsSince(start) * 1e6 / (2 * moves);
+		allocations = allocationCount() - allocations;
+
+		double fullMs = 0;
+		int fullChecks = max(10, moves / (size * 4));
+		for (int i = 0; i < fullChecks; i++)
+		{
+			n.unpackCells(packed); //marks every line
+			start = high_resolution_clock::now();
+			solved += n.isSolved();
+			fullMs += millisecondsSince(start);
+		}
+
+		out << right << setw(5) << size << 'x' << left << setw(5) << size << right << fixed << setprecision(0)
+			<< setw(14) << moveNs << setw(14) << fullMs * 1e6 / fullChecks << setw(14) << allocations << (solved < 0 ? " " : "") << '\n';
+		out.flush();
+	}
+	out.unsetf(ios::fixed);
+}
+
+void benchmarkLineCache(ostream& out)
+{
+	const int sizes[] = { 20, 30, 40, 60, 100 };
+	const int puzzles = 5;
+	const int fillPercent = 60; //sparse enough that the line search has to guess
+	const long long nodeLimit = 2000;
+	const unsigned seed = 2020;
+
+	LineCache& cache = LineCache::shared();
+	out << left << setw(9) << " size" << right << setw(10) << "off ms" << setw(12) << "empty ms" << setw(12) << "warm ms"
+		<< setw(12) << "lookups" << setw(10) << "hit %" << setw(12) << "evictions" << setw(8) << "solved" << '\n';
+	for (int size : sizes)
+	{
+		PuzzleGenerator generator(seed + size);
+		vector<Nonogram> corpus;
+		for (int i = 0; i < puzzles; i++)
+			corpus.push_back(generator.puzzle(size, size, fillPercent / 100.0));
+
+		double ms[3] = { 0, 0, 0 }; //cache off, cleared before each puzzle, already holding every puzzle
+		int solved = 0;
+		LineCacheStats before;
+		for (int run = 0; run < 3; run++)
+		{
+			cache.setEnabled(run > 0);
+			if (run == 2) //fill the cache with the whole corpus first, like a batch seeing the same puzzles again
+			{
+				cache.clear();
+				for (Nonogram n : corpus)
+				{
+					SearchStats stats;
+					stats.nodeLimit = nodeLimit;
+					solveByLines(n, stats);
+				}
+				before = cache.stats();
+			}
+			for (Nonogram n : corpus)
+			{
+				if (run == 1)
+					cache.clear();
+				SearchStats stats;
+				stats.nodeLimit = nodeLimit;
+				auto start = high_resolution_clock::now();
+				bool found = solveByLines(n, stats);
+				ms[run] += millisecondsSince(start);
+				solved += run == 0 && found;
+			}
+		}
+		LineCacheStats warm = cache.stats();
+		warm.hits -= before.hits;
+		warm.misses -= before.misses;
+		warm.evictions -= before.evictions;
+		cache.setEnabled(true);
+
+		uint64_t lookups = warm.hits + warm.misses;
+		out << right << setw(4) << size << 'x' << left << setw(4) << size << right << fixed << setprecision(2)
+			<< setw(10) << ms[0] << setw(12) << ms[1] << setw(12) << ms[2] << setw(12) << lookups << setprecision(1)
+			<< setw(10) << 100.0 * warm.hits / max<uint64_t>(1, lookups) << setw(12) << warm.evictions << setw(6) << solved << '/' << puzzles << '\n';
+		out.flush();
+	}
+	out.unsetf(ios::fixed);
+}
+
+void benchmarkPlacements(ostream& out)
+{
+	const double setLimit = 100000; //placements past this take the set based functions seconds and hundreds of MB
+	const double minimumMs = 20; //each function is repeated until it has run this long
+
+	out << right << setw(6) << "width" << setw(8) << "blocks" << setw(12) << "placements" << setw(12) << "set ms"
+		<< setw(14) << "iterator ms" << setw(10) << "speedup" << setw(8) << "agree" << '\n';
+	for (int width = 5; width <= 50; width += 5)
+	{
+		vector<int> clue((width + 1) / 5, 3); //blocks of 3, about a fifth of the line left as slack
+		double placements = countLineOptions(clue, width);
+
+		//the iterator writes every candidate straight into one buffer sized up front
+		vector<char> buffer((size_t)placements * width);
+		int iterations = 0;
+		auto start = high_resolution_clock::now();
+		do
+		{
+			char* line = buffer.data();
+			for (PlacementEnumerator placement(clue, width); !placement.done(); placement.next(), line += width)
+				placement.writeLine(line);
+			iterations++;
+		} while (millisecondsSince(start) < minimumMs);
+		double iteratorMs = millisecondsSince(start) / iterations;
+
+		out << setw(6) << width << setw(8) << clue.size() << setw(12) << (long long)placements << fixed << setprecision(3);
+		if (placements > setLimit)
+		{
+			out << setw(12) << '-' << setw(14) << iteratorMs << setw(10) << '-' << setw(8) << '-' << '\n';
+			out.flush();
+			continue;
+		}
+
+		int lineWidth = getWidth(clue);
+		int sum = getSum(clue, lineWidth, width);
+		vector<vector<char>> decoded;
+		iterations = 0;
+		start = high_resolution_clock::now();
+		do
+		{
+			decoded.clear();
+			for (const vector<int>& gaps : getLineSet(lineWidth, sum))
+				decoded.push_back(decodeLineSet(gaps, clue, width));
+			iterations++;
+		} while (millisecondsSince(start) < minimumMs);
+		double setMs = millisecondsSince(start) / iterations;
+
+		bool agree = decoded.size() == (size_t)placements;
+		for (size_t i = 0; agree && i < decoded.size(); i++)
+			agree = equal(decoded[i].begin(), decoded[i].end(), buffer.begin() + i * width);
+
+		out << setw(12) << setMs << setw(14) << iteratorMs << setprecision(1) << setw(9) << setMs / iteratorMs << 'x'
+			<< setw(8) << (agree ? "yes" : "no") << '\n';
+		out.flush();
+	}
+	out.unsetf(ios::fixed);
+}
+
+void benchmarkCellKernel(ostream& out)
+{
+	const int lengths[] = { 20, 64, 100, 200 };
+	const int candidates = 1 << 16;
+	const double minimumMs = 50; //each kernel is repeated until it has run this long
+
+	CellKernel original = activeCellKernel();
+	out << "avx2 " << (avx2Supported() ? "supported" : "not supported") << ", one thread\n";
+	out << right << setw(7) << "length" << setw(12) << "candidates" << setw(14) << "scalar M/s" << setw(12) << "avx2 M/s"
+		<< setw(10) << "speedup" << setw(8) << "agree" << '\n';
+	for (int length : lengths)
+	{
+		PuzzleGenerator generator(2020 + length);
+		LineDomain domain(length);
+		vector<char> line(length);
+		for (int i = 0; i < candidates; i++)
+		{
+			for (int cell = 0; cell < length; cell++)
+				line[cell] = generator.next() & 1 ? 'X' : ' ';
+			domain.addLine(line);
+		}
+
+		double rate[2] = { 0, 0 }; //candidates tested per microsecond, i.e. millions per second
+		long long counted[2] = { 0, 0 }; //filled cells summed over one pass, both kernels have to agree
+		for (CellKernel kernel : { KERNEL_SCALAR, KERNEL_AVX2 })
+		{
+			setCellKernel(kernel);
+			if (activeCellKernel() != kernel)
+				continue;
+			long long passes = 0;
+			auto start = high_resolution_clock::now();
+			do
+			{
+				long long filled = 0;
+				for (int cell = 0; cell < length; cell++)
+					filled += domain.countCell(cell, true);
+				counted[kernel] = filled;
+				passes++;
+			} while (millisecondsSince(start) < minimumMs);
+			rate[kernel] = (double)passes * length * candidates / (millisecondsSince(start) * 1000);
+		}
+
+		out << setw(7) << length << setw(12) << candidates << fixed << setprecision(1) << setw(14) << rate[KERNEL_SCALAR];
+		if (rate[KERNEL_AVX2] > 0)
+			out << setw(12) << rate[KERNEL_AVX2] << setw(9) << rate[KERNEL_AVX2] / rate[KERNEL_SCALAR] << 'x'
+				<< setw(8) << (counted[KERNEL_AVX2] == counted[KERNEL_SCALAR] ? "yes" : "no") << '\n';
+		else
+			out << setw(12) << '-' << setw(10) << '-' << setw(8) << '-' << '\n';
+		out.flush();
+	}
+	setCellKernel(original);
+	out.unsetf(ios::fixed);
+}
+
+void benchmarkSmallBoards(ostream& out)
+{
+	const int sizes[] = { 5, 10, 15 };
+	const int puzzles = 200;
+	const unsigned seed = 2020;
+
+	out << left << setw(9) << " size" << right << setw(12) << "lines us" << setw(14) << "lines allocs" << setw(12) << "small us"
+		<< setw(14) << "small allocs" << setw(10) << "speedup" << setw(8) << "agree" << '\n';
+	for (int size : sizes)
+	{
+		PuzzleGenerator generator(seed + size);
+		vector<Nonogram> corpus;
+		for (int i = 0; i < puzzles; i++)
+		{
+			corpus.push_back(generator.puzzle(size, size));
+			corpus.back().clearGrid();
+		}
+
+		LineCache::shared().clear(); //the line solver starts cold, it has not seen these puzzles
+		double lineMs = 0, smallMs = 0;
+		size_t lineAllocations = 0, smallAllocations = 0;
+		int agree = 0;
+		for (const Nonogram& puzzle : corpus)
+		{
+			Nonogram lines = puzzle, small = puzzle;
+			SearchStats lineStats, smallStats;
+			size_t allocations = allocationCount();
+			auto start = high_resolution_clock::now();
+			bool lineSolved = solveByLines(lines, lineStats);
+			lineMs += millisecondsSince(start);
+			lineAllocations += allocationCount() - allocations;
+
+			allocations = allocationCount();
+			start = high_resolution_clock::now();
+			bool smallSolved = solveSmall(small, smallStats);
+			smallMs += millisecondsSince(start);
+			smallAllocations += allocationCount() - allocations;
+			agree += lineSolved == smallSolved && lines == small;
+		}
+		out << right << setw(4) << size << 'x' << left << setw(4) << size << right << fixed << setprecision(2)
+			<< setw(12) << lineMs * 1000 / puzzles << setw(14) << lineAllocations / puzzles << setw(12) << smallMs * 1000 / puzzles
+			<< setw(14) << smallAllocations / puzzles << setprecision(1) << setw(9) << lineMs / smallMs << 'x'
+			<< setw(4) << agree << '/' << puzzles << '\n';
+		out.flush();
+	}
+	out.unsetf(ios::fixed);
+}
+
+void benchmarkUniqueness(ostream& out)
+{
+	const int sizes[] = { 10, 15, 20 }; //random 25x25 boards can take minutes to count
+	const int puzzles = 20;
+	const unsigned seed = 2020;
+	int threads = ThreadPool::defaultThreads();
+
+	out << left << setw(9) << " size" << right << setw(10) << "unique" << setw(10) << "multiple" << setw(12) << "1 thread ms"
+		<< setw(9) << threads << setw(10) << " thread ms" << setw(10) << "speedup" << setw(8) << "agree" << '\n';
+	for (int size : sizes)
+	{
+		int unique = 0, agree = 0;
+		double sequentialMs = 0, parallelMs = 0;
+		PuzzleGenerator generator(seed + size);
+		for (int i = 0; i < puzzles; i++)
+		{
+			Nonogram n = generator.puzzle(size, size);
+			SearchStats sequentialStats, parallelStats;
+			auto start = high_resolution_clock::now();
+			long long sequential = countSolutions(n, 2, sequentialStats);
+			sequentialMs += millisecondsSince(start);
+
+			start = high_resolution_clock::now();
+			long long parallel = countSolutions(n, 2, parallelStats, threads);
+			parallelMs += millisecondsSince(start);
+
+			unique += sequential == 1;
+			agree += sequential == parallel;
+		}
+		out << right << setw(4) << size << 'x' << left << setw(4) << size << right << fixed << setprecision(2)
+			<< setw(10) << unique << setw(10) << puzzles - unique << setw(12) << sequentialMs << setw(19) << parallelMs
+			<< setprecision(1) << setw(9) << sequentialMs / parallelMs << 'x' << setw(5) << agree << '/' << puzzles << '\n';
+		out.flush();
+	}
+	out.unsetf(ios::fixed);
+}
+
+void benchmarkProbing(ostream& out)
+{
+	const int sizes[] = { 20, 25, 30 };
+	const int macSizes = 20; //past this maintained consistency without probing runs for minutes
+	const int puzzles = 10;
+	const long long nodeLimit = 20000;
+	const unsigned seed = 2020;
+
+	out << left << setw(9) << " size" << setw(7) << "search" << right << setw(8) << "solved" << setw(10) << "nodes"
+		<< setw(12) << "ms" << setw(14) << "probe solved" << setw(10) << "nodes" << setw(12) << "ms" << setw(10) << "settled" << '\n';
+	for (int size : sizes)
+		for (bool mac : { false, true })
+		{
+			if (mac && size > macSizes)
+				continue;
+			int solved[2] = { 0, 0 };
+			long long nodes[2] = { 0, 0 }, settled = 0;
+			double ms[2] = { 0, 0 };
+			PuzzleGenerator generator(seed + size);
+			for (int i = 0; i < puzzles; i++)
+			{
+				Nonogram n = generator.puzzle(size, size);
+				for (int probing = 0; probing < 2; probing++)
+				{
+					SearchStats stats;
+					stats.nodeLimit = nodeLimit;
+					stats.probeLimit = probing ? defaultProbeLimit : 0;
+					auto start = high_resolution_clock::now();
+					if (mac)
+					{
+						vector<LineDomain> rowDomain = getRowOptions(n), columnDomain = getColumnOptions(n);
+						SupportCounter counter(rowDomain, columnDomain);
+						solved[probing] += counter.propagate() && macBacktrack(counter, stats);
+					}
+					else
+					{
+						vector<vector<char>> grid(size, vector<char>(size, ' '));
+						solved[probing] += lineSearch(n, grid, stats);
+					}
+					ms[probing] += millisecondsSince(start);
+					nodes[probing] += stats.nodes;
+					settled += stats.settled;
+				}
+			}
+			out << right << setw(4) << size << 'x' << left << setw(4) << size << setw(7) << (mac ? "mac" : "lines") << right
+				<< fixed << setprecision(2) << setw(5) << solved[0] << '/' << puzzles << setw(10) << nodes[0] << setw(12) << ms[0]
+				<< setw(11) << solved[1] << '/' << puzzles << setw(10) << nodes[1] << setw(12) << ms[1] << setw(10) << settled << '\n';
+			out.flush();
+		}
+	out.unsetf(ios::fixed);
+}
+
+void benchmarkBackjump(ostream& out)
+{
+	const int sizes[] = { 15, 20, 25 };
+	const int puzzles = 4;
+	const long long nodeLimit = 5000; //the corpus of benchmarkMac, a '>' marks searches that gave up
+	const unsigned seed = 2020;
+
+	out << left << setw(9) << " size" << right << setw(8) << "puzzle" << setw(12) << "fc nodes" << setw(12) << "fc ms"
+		<< setw(12) << "cbj nodes" << setw(12) << "cbj ms" << setw(10) << "jumps" << setw(10) << "distance"
+		<< setw(10) << "learned" << setw(10) << "hits" << setw(7) << "same" << '\n';
+	for (int size : sizes)
+	{
+		PuzzleGenerator generator(seed + size);
+		for (int i = 0; i < puzzles; i++)
+		{
+			Nonogram n = generator.puzzle(size, size);
+			vector<bool> rowLazy, columnLazy;
+			vector<LineDomain> rowDomain = getRowOptions(n, defaultLineBudget, rowLazy);
+			vector<LineDomain> columnDomain = getColumnOptions(n, defaultLineBudget, columnLazy);
+			if (!supportConsistency(rowDomain, columnDomain))
+				continue;
+
+			vector<LineDomain> fcRows = rowDomain, fcColumns = columnDomain;
+			vector<bool> rowAssign(size, false), columnAssign(size, false);
+			vector<trailType> trail;
+			SearchStats fcStats;
+			fcStats.nodeLimit = nodeLimit;
+			auto start = high_resolution_clock::now();
+			bool fcSolved = backtrack(fcRows, fcColumns, rowAssign, columnAssign, trail, fcStats);
+			double fcMs = millisecondsSince(start);
+
+			vector<LineDomain> cbjRows = rowDomain, cbjColumns = columnDomain;
+			SearchStats cbjStats;
+			cbjStats.nodeLimit = nodeLimit;
+			start = high_resolution_clock::now();
+			bool cbjSolved = backjump(cbjRows, cbjColumns, cbjStats);
+			double cbjMs = millisecondsSince(start);
+
+			//both take the first solution in the same order, a jump only skips branches without one
+			string same = "-";
+			if (fcSolved && cbjSolved)
+			{
+				same = "yes";
+				for (int y = 0; y < size; y++)
+					if (fcRows[y].first() != cbjRows[y].first())
+						same = "no";
+			}
+
+			out << right << setw(4) << size << 'x' << left << setw(4) << size << right << setw(8) << i << fixed << setprecision(2)
+				<< setw(12) << (fcStats.limitReached() ? ">" + to_string(fcStats.nodes) : to_string(fcStats.nodes)) << setw(12) << fcMs
+				<< setw(12) << (cbjStats.limitReached() ? ">" + to_string(cbjStats.nodes) : to_string(cbjStats.nodes)) << setw(12) << cbjMs
+				<< setw(10) << cbjStats.backjumps << setw(10) << (cbjStats.backjumps ? (double)cbjStats.jumpedLevels / cbjStats.backjumps : 0.0)
+				<< setw(10) << cbjStats.nogoodsLearned << setw(10) << cbjStats.nogoodHits << setw(7) << same << '\n';
+			out.flush();
+		}
+	}
+	out.unsetf(ios::fixed);
+}
+
+void benchmarkSat(ostream& out)
+{
+	const int sizes[] = { 20, 25, 30 };
+	const int puzzles = 10;
+	const long long nodeLimit = 20000; //guessed cells for lines, decisions for sat
+	const unsigned seed = 2020;
+	const char* names[] = { "lines", "probing", "sat" };
+
+	out << left << setw(9) << " size" << setw(9) << "solver" << right << setw(8) << "solved" << setw(10) << "nodes"
+		<< setw(12) << "ms" << setw(12) << "conflicts" << setw(8) << "wins" << '\n';
+	for (int size : sizes)
+	{
+		int solved[3] = {}, wins[3] = {};
+		long long nodes[3] = {}, conflicts = 0;
+		double ms[3] = {};
+		PuzzleGenerator generator(seed + size);
+		for (int i = 0; i < puzzles; i++)
+		{
+			Nonogram n = generator.puzzle(size, size);
+			double puzzleMs[3];
+			bool puzzleSolved[3];
+			for (int solver = 0; solver < 3; solver++)
+			{
+				SearchStats stats;
+				stats.nodeLimit = nodeLimit;
+				stats.probeLimit = solver == 1 ? defaultProbeLimit : 0;
+				auto start = high_resolution_clock::now();
+				if (solver < 2)
+				{
+					vector<vector<char>> grid(size, vector<char>(size, ' '));
+					puzzleSolved[solver] = lineSearch(n, grid, stats);
+				}
+				else
+				{
+					SatSolver sat(encodeNonogram(n)); //encoding is part of the cost like building domains
+					puzzleSolved[solver] = sat.solve(stats) == SAT_SATISFIABLE;
+					conflicts += sat.getStats().conflicts;
+				}
+				puzzleMs[solver] = millisecondsSince(start);
+				solved[solver] += puzzleSolved[solver];
+				nodes[solver] += stats.nodes;
+				ms[solver] += puzzleMs[solver];
+			}
+			int fastest = -1; //the quickest solver that solved it
+			for (int solver = 0; solver < 3; solver++)
+				if (puzzleSolved[solver] && (fastest == -1 || puzzleMs[solver] < puzzleMs[fastest]))
+					fastest = solver;
+			if (fastest != -1)
+				wins[fastest]++;
+		}
+		for (int solver = 0; solver < 3; solver++)
+			out << right << setw(4) << size << 'x' << left << setw(4) << size << setw(9) << names[solver] << right << fixed << setprecision(2)
+				<< setw(5) << solved[solver] << '/' << puzzles << setw(10) << nodes[solver] << setw(12) << ms[solver]
+				<< setw(12) << (solver == 2 ? to_string(conflicts) : "-") << setw(8) << wins[solver] << '\n';
+		out.flush();
+	}
+	out.unsetf(ios::fixed);
+}
+
+void benchmarkBranching(ostream& out)
+{
+	const int sizes[] = { 10, 15, 20 };
+	const int puzzles = 10;
+	const long long nodeLimit = 20000; //past 20x20 every strategy gives up on the same puzzles
+	const unsigned seed = 2020;
+	const Branching strategies[] = { BRANCH_SMALLEST, BRANCH_WEIGHTED_DEGREE, BRANCH_CONTESTED_CELL };
+	const char* names[] = { "smallest", "wdeg", "cell" };
+
+	out << left << setw(9) << " size" << setw(10) << "branch" << setw(9) << "values" << right << setw(8) << "solved"
+		<< setw(10) << "nodes" << setw(12) << "ms" << '\n';
+	for (int size : sizes)
+	{
+		vector<Nonogram> corpus;
+		vector<vector<LineDomain>> rowDomains, columnDomains; //consistent before the search, each strategy copies them
+		PuzzleGenerator generator(seed + size);
+		for (int i = 0; i < puzzles; i++)
+		{
+			Nonogram n = generator.puzzle(size, size);
+			vector<bool> rowLazy, columnLazy;
+			vector<LineDomain> rowDomain = getRowOptions(n, defaultLineBudget, rowLazy);
+			vector<LineDomain> columnDomain = getColumnOptions(n, defaultLineBudget, columnLazy);
+			if (!supportConsistency(rowDomain, columnDomain))
+				continue;
+			corpus.push_back(n);
+			rowDomains.push_back(move(rowDomain));
+			columnDomains.push_back(move(columnDomain));
+		}
+
+		for (int strategy = 0; strategy < 3; strategy++)
+			for (bool supportOrder : { false, true })
+			{
+				int solved = 0;
+				long long nodes = 0;
+				double ms = 0;
+				for (int i = 0; i < corpus.size(); i++)
+				{
+					vector<LineDomain> rowDomain = rowDomains[i], columnDomain = columnDomains[i];
+					vector<bool> rowAssign(size, false), columnAssign(size, false);
+					vector<trailType> trail;
+					SearchStats stats;
+					stats.nodeLimit = nodeLimit;
+					stats.branching = strategies[strategy];
+					stats.supportOrder = supportOrder;
+					auto start = high_resolution_clock::now();
+					bool found = backtrack(rowDomain, columnDomain, rowAssign, columnAssign, trail, stats);
+					ms += millisecondsSince(start);
+					nodes += stats.nodes;
+
+					Nonogram n = corpus[i]; //a solution only counts when it meets the clues
+					for (int x = 0; found && x < size; x++)
+						for (int y = 0; y < size; y++)
+							n[x][y] = columnDomain[x].getCell(columnDomain[x].first(), y);
+					solved += found && n.isSolved();
+				}
+				out << right << setw(4) << size << 'x' << left << setw(4) << size << setw(10) << names[strategy]
+					<< setw(9) << (supportOrder ? "support" : "first") << right << fixed << setprecision(2) << setw(5) << solved
+					<< '/' << corpus.size() << setw(10) << nodes << setw(12) << ms << '\n';
+				out.flush();
+			}
+	}
+	out.unsetf(ios::fixed);
+}
+
+void benchmarkPortfolio(ostream& out)
+{
+	const int sizes[] = { 20, 25, 30 };
+	const int puzzles = 10;
+	const int racers = 4; //lines, sat, mac and weighted forward checking
+	const long long nodeLimit = 5000; //per configuration, forward checking alone still takes tens of seconds on some 30x30 puzzles
+	const unsigned seed = 2020;
+	const char* names[] = { "lines", "sat", "mac", "forward", "portfolio" };
+
+	vector<PortfolioConfig> configs = defaultPortfolio(racers);
+	out << "hardware threads: " << ThreadPool::defaultThreads() << '\n';
+	out << left << setw(9) << " size" << setw(11) << "solver" << right << setw(8) << "solved" << setw(12) << "ms"
+		<< setw(12) << "worst ms" << setw(10) << "nodes" << '\n';
+	for (int size : sizes)
+	{
+		int solved[racers + 1] = {};
+		double ms[racers + 1] = {}, worst[racers + 1] = {};
+		long long nodes[racers + 1] = {};
+		PuzzleGenerator generator(seed + size);
+		for (int i = 0; i < puzzles; i++)
+		{
+			Nonogram puzzle = generator.puzzle(size, size);
+			puzzle.clearGrid();
+			for (int racer = 0; racer <= racers; racer++) //each configuration alone, then all of them racing
+			{
+				Nonogram n = puzzle;
+				PortfolioReport report;
+				auto start = high_resolution_clock::now();
+				vector<PortfolioConfig> race = racer < racers ? vector<PortfolioConfig>{ configs[racer] } : configs;
+				solved[racer] += solvePortfolio(n, race, report, nodeLimit) == PORTFOLIO_SOLVED;
+				double puzzleMs = millisecondsSince(start);
+				ms[racer] += puzzleMs;
+				worst[racer] = max(worst[racer], puzzleMs);
+				nodes[racer] += report.nodes;
+			}
+		}
+		for (int racer = 0; racer <= racers; racer++)
+			out << right << setw(4) << size << 'x' << left << setw(4) << size << setw(11) << names[racer] << right << fixed
+				<< setprecision(2) << setw(5) << solved[racer] << '/' << puzzles << setw(12) << ms[racer] << setw(12) << worst[racer]
+				<< setw(10) << nodes[racer] << '\n';
+		out.flush();
+	}
+	out.unsetf(ios::fixed);
+}
+
+struct ArenaRun //what solving a corpus cost
+{
+	int solved = 0;
+	double ms = 0; //wall time of the whole corpus
+	size_t heapAllocations = 0;
+	size_t arenaAllocations = 0;
+	size_t arenaPeak = 0; //of the largest solve
+	double allocatorMs = 0; //heap and arena, only while timed
+};
+
+//every puzzle through solve() on threads workers like a batch, with the line cache cold
+static ArenaRun solveCorpus(const vector<Nonogram>& corpus, Propagation mode, int threads, bool timed)
+{
+	ArenaRun run;
+	mutex lock;
+	LineCache::shared().clear();
+	setAllocationTiming(timed);
+	long long heapNanoseconds = allocationNanoseconds();
+	size_t allocations = allocationCount();
+	auto start = high_resolution_clock::now();
+	{
+		ThreadPool pool(threads);
+		for (int i = 0; i < corpus.size(); i++)
+			pool.submit([&, i]()
+			{
+				Nonogram n = corpus[i];
+				SolveReport report;
+				ostream quiet(nullptr);
+				bool solved = solve(n, report, quiet, mode) && n.isSolved();
+				lock_guard<mutex> guard(lock);
+				run.solved += solved;
+				run.arenaAllocations += report.arenaAllocations;
+				run.arenaPeak = max(run.arenaPeak, report.arenaPeak);
+				run.allocatorMs += report.arenaNanoseconds / 1e6;
+			});
+		pool.wait();
+	}
+	run.ms = millisecondsSince(start);
+	run.heapAllocations = allocationCount() - allocations;
+	run.allocatorMs += (allocationNanoseconds() - heapNanoseconds) / 1e6;
+	setAllocationTiming(false);
+	return run;
+}
+
+void benchmarkArena(ostream& out)
+{
+	const int sizes[] = { 15, 20, 25 };
+	const int puzzles = 8;
+	const unsigned seed = 2020;
+	const Propagation modes[] = { LINE_SOLVING, SUPPORT_COUNTING, SAT_SOLVING };
+	const char* modeNames[] = { "lines", "support", "sat" };
+	int threads = ThreadPool::defaultThreads();
+
+	out << "hardware threads: " << threads << ", allocator time from a separate timed run\n";
+	out << left << setw(9) << " size" << setw(9) << "mode" << setw(7) << "arena" << right << setw(8) << "solved" << setw(10) << "ms"
+		<< setw(5) << threads << setw(10) << " thread ms" << setw(13) << "heap allocs" << setw(14) << "arena allocs"
+		<< setw(12) << "alloc ms" << setw(11) << "arena KiB" << '\n';
+	for (int size : sizes)
+	{
+		PuzzleGenerator generator(seed + size);
+		vector<Nonogram> corpus;
+		for (int i = 0; i < puzzles; i++)
+		{
+			corpus.push_back(generator.puzzle(size, size));
+			corpus.back().clearGrid();
+		}
+		for (int m = 0; m < 3; m++)
+			for (bool arena : { false, true })
+			{
+				Arena::setEnabled(arena);
+				ArenaRun sequential = solveCorpus(corpus, modes[m], 1, false);
+				ArenaRun parallel = threads > 1 ? solveCorpus(corpus, modes[m], threads, false) : sequential;
+				ArenaRun timed = solveCorpus(corpus, modes[m], 1, true); //the clock slows every allocation, so its times are kept apart
+				out << right << setw(4) << size << 'x' << left << setw(4) << size << setw(9) << modeNames[m] << setw(7)
+					<< (arena ? "on" : "off") << right << fixed << setprecision(2) << setw(5) << sequential.solved << '/' << puzzles
+					<< setw(10) << sequential.ms << setw(15) << parallel.ms << setw(13) << sequential.heapAllocations / puzzles
+					<< setw(14) << sequential.arenaAllocations / puzzles << setw(12) << timed.allocatorMs
+					<< setw(11) << sequential.arenaPeak / 1024 << '\n';
+				out.flush();
+			}
+	}
+	Arena::setEnabled(true);
+	out.unsetf(ios::fixed);
+}
@@ -0,0 +1,35 @@
+//timing and memory comparisons between solver implementations
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <iostream>
+using std::ostream;
+
+void benchmarkDomains(ostream& out); //packed LineDomain against the original set<vector<char>> domains
+void benchmarkPropagation(ostream& out); //AC-3 against support counting on the same packed domains
+void benchmarkLineSolver(ostream& out); //enumerated domains against line solving, which also runs sizes the domains cannot
+
+void benchmarkSearch(ostream& out); //the copying set backtracker against the trail backtracker, nodes and heap use
+void benchmarkMac(ostream& out); //forward checking against maintained consistency, per puzzle nodes and time
+void benchmarkParallel(ostream& out); //sequential against parallel maintained consistency search by thread count
+
+//seeded corpora by size and fill density run through the phases of solve() with support counting and through the line
+//solving default as a whole, one csv row per corpus and phase with wall time percentiles and peak heap, meant to be kept
+//and compared between versions. the peak columns are empty without NONOGRAMS_TRACK_MEMORY
+void benchmarkSuite(ostream& out);
+void benchmarkGenerator(ostream& out); //seeded puzzles generated per second, as Nonograms and as reused label vectors
+void benchmarkSetup(ostream& out); //heap allocations of building a puzzle, reading its labels and building its domains
+void benchmarkVerify(ostream& out); //isSolved after a single move against a check of every line
+void benchmarkLineCache(ostream& out); //line solving without the line cache, with it empty and with it holding the same puzzles
+void benchmarkPlacements(ostream& out); //getLineSet and decoding against PlacementEnumerator for line widths 5 to 50
+void benchmarkCellKernel(ostream& out); //candidates tested per second by one cell, scalar against avx2 selectCell
+void benchmarkSmallBoards(ostream& out); //solveByLines against the fixed size SmallSolver, time and heap allocations per puzzle
+void benchmarkUniqueness(ostream& out); //share of random puzzles with a unique solution, checked on one thread and on all of them
+void benchmarkProbing(ostream& out); //line search and maintained consistency with and without probing, under a node limit
+void benchmarkBackjump(ostream& out); //forward checking with chronological backtracking against backjumping with nogoods
+void benchmarkBranching(ostream& out); //node counts and times of backtrack under each branching strategy and value order
+void benchmarkSat(ostream& out); //line search with and without probing against the clause learning solver, and which is fastest how often
+void benchmarkPortfolio(ostream& out); //each configuration of a portfolio alone against the race, total and worst solve times
+void benchmarkArena(ostream& out); //solves with and without their arena, heap and arena allocations and time spent allocating
+
+#endif
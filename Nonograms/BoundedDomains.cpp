@@ -0,0 +1,166 @@
+#include "BoundedDomains.h"
+#include "LineSolver.h"
+#include "LineCache.h"
+using namespace std;
+
+double countLineOptions(const vector<int>& clue, int length)
+{
+	int blocks = clue.size();
+	int free = length - (blocks - 1); //cells left for the blocks and the extra gaps
+	for (int block : clue)
+		free -= block;
+	if (blocks == 0)
+		return 1;
+	if (free < 0)
+		return 0;
+
+	//spreading free extra gap cells over blocks + 1 gaps is choose(free + blocks, blocks)
+	double count = 1;
+	for (int i = 1; i <= blocks; i++)
+		count = count * (free + i) / i;
+	return count;
+}
+
+//place block and the ones after it starting no earlier than start, line holds the blocks placed so far
+static void placeBlock(const vector<int>& clue, const vector<char>& known, const vector<int>& minimumLength, int block, int start, vector<char>& line, LineDomain& domain)
+{
+	int length = line.size();
+	if (block == clue.size())
+	{
+		for (int cell = start; cell < length; cell++) //the rest of the line is a gap
+			if (known[cell] == 'X')
+				return;
+		domain.addLine(line);
+		return;
+	}
+
+	for (int s = start; s + minimumLength[block] <= length; s++)
+	{
+		if (s > start && known[s - 1] == 'X') //the gap before the block cannot skip a filled cell
+			break;
+		int end = s + clue[block];
+		bool fits = end == length || known[end] != 'X';
+		for (int cell = s; cell < end && fits; cell++)
+			fits = known[cell] != '-';
+		if (!fits)
+			continue;
+
+		for (int cell = s; cell < end; cell++)
+			line[cell] = 'X';
+		placeBlock(clue, known, minimumLength, block + 1, end + 1, line, domain);
+		for (int cell = s; cell < end; cell++)
+			line[cell] = ' ';
+	}
+}
+
+void addPlacements(const vector<int>& clue, const vector<char>& known, LineDomain& domain)
+{
+	vector<int> minimumLength(clue.size() + 1, 0); //minimumLength[b] cells needed by blocks b and on
+	for (int b = (int)clue.size() - 1; b >= 0; b--)
+		minimumLength[b] = minimumLength[b + 1] + clue[b] + (b + 1 < clue.size() ? 1 : 0);
+
+	vector<char> line(known.size(), ' ');
+	placeBlock(clue, known, minimumLength, 0, 0, line, domain);
+}
+
+static vector<LineDomain> getBoundedOptions(int lines, int length, double lineBudget, vector<bool>& lazy, const vector<vector<int>>& clues)
+{
+	vector<LineDomain> options;
+	options.reserve(lines);
+	lazy.assign(lines, false);
+	vector<char> unknown(length, ' ');
+	for (int i = 0; i < lines; i++)
+	{
+		options.push_back(LineDomain(length));
+		if (countLineOptions(clues[i], length) > lineBudget)
+			lazy[i] = true; //left empty until its known cells narrow it down
+		else
+			addPlacements(clues[i], unknown, options[i]);
+	}
+	return options;
+}
+
+vector<LineDomain> getRowOptions(const Nonogram& n, double lineBudget, vector<bool>& lazy)
+{
+	return getBoundedOptions(n.getHeight(), n.getWidth(), lineBudget, lazy, n.getRows());
+}
+vector<LineDomain> getColumnOptions(const Nonogram& n, double lineBudget, vector<bool>& lazy)
+{
+	return getBoundedOptions(n.getWidth(), n.getHeight(), lineBudget, lazy, n.getColumns());
+}
+
+//bring one line up to date with the grid, false on a contradiction
+static bool reviseLine(const vector<int>& clue, LineDomain& domain, bool& lazy, vector<char>& known, double lineBudget)
+{
+	if (lazy)
+	{
+		if (!LineCache::shared().solve(clue, known))
+			return false;
+		if (countPlacements(clue, known) <= lineBudget) //small enough to keep now
+		{
+			addPlacements(clue, known, domain);
+			lazy = false;
+		}
+		return true;
+	}
+
+	domain.restrictTo(known);
+	if (domain.empty())
+		return false;
+	domain.fillForced(known);
+	return true;
+}
+
+bool boundedConsistency(const Nonogram& n, vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain,
+	vector<bool>& rowLazy, vector<bool>& columnLazy, vector<vector<char>>& grid, double lineBudget)
+{
+	int w = n.getWidth();
+	int h = n.getHeight();
+	vector<bool> rowQueued(h, true);
+	vector<bool> columnQueued(w, true);
+	vector<char> line;
+	bool changed = true;
+	while (changed)
+	{
+		changed = false;
+		for (int y = 0; y < h; y++)
+		{
+			if (!rowQueued[y])
+				continue;
+			rowQueued[y] = false;
+			line.resize(w);
+			for (int x = 0; x < w; x++)
+				line[x] = grid[x][y];
+			bool lazy = rowLazy[y];
+			if (!reviseLine(n.getRow(y), rowDomain[y], lazy, line, lineBudget))
+				return false;
+			rowLazy[y] = lazy;
+			for (int x = 0; x < w; x++)
+				if (line[x] != grid[x][y]) //a newly known cell dirties its column
+				{
+					grid[x][y] = line[x];
+					columnQueued[x] = true;
+					changed = true;
+				}
+		}
+		for (int x = 0; x < w; x++)
+		{
+			if (!columnQueued[x])
+				continue;
+			columnQueued[x] = false;
+			line = grid[x];
+			bool lazy = columnLazy[x];
+			if (!reviseLine(n.getColumn(x), columnDomain[x], lazy, line, lineBudget))
+				return false;
+			columnLazy[x] = lazy;
+			for (int y = 0; y < h; y++)
+				if (line[y] != grid[x][y])
+				{
+					grid[x][y] = line[y];
+					rowQueued[y] = true;
+					changed = true;
+				}
+		}
+	}
+	return true;
+}
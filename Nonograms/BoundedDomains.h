@@ -0,0 +1,26 @@
+//domain construction under a per line candidate budget, lines over it stay lazy and are handled by the line solver
+#ifndef BOUNDEDDOMAINS_H
+#define BOUNDEDDOMAINS_H
+
+#include "Nonogram.h"
+#include "LineDomain.h"
+#include <vector>
+using std::vector;
+
+const double defaultLineBudget = 100000; //candidates a single line may materialize, about 0.8 MB per 60 wide line
+
+double countLineOptions(const vector<int>& clue, int length); //placements of the clue in an empty line, closed form
+
+//append every placement of the clue that agrees with the known cells (' ' unknown, '-' empty, 'X' filled) to the domain
+void addPlacements(const vector<int>& clue, const vector<char>& known, LineDomain& domain);
+
+//like getRowOptions/getColumnOptions, but lines with more than lineBudget candidates are left empty and marked lazy
+vector<LineDomain> getRowOptions(const Nonogram& n, double lineBudget, vector<bool>& lazy);
+vector<LineDomain> getColumnOptions(const Nonogram& n, double lineBudget, vector<bool>& lazy);
+
+//exchange known cells between the domains and the lazy lines until nothing changes, false on a contradiction.
+//a lazy line is materialized once the placements left by its known cells fit the budget. grid[x][y] like Nonogram
+bool boundedConsistency(const Nonogram& n, vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain,
+	vector<bool>& rowLazy, vector<bool>& columnLazy, vector<vector<char>>& grid, double lineBudget);
+
+#endif
@@ -0,0 +1,125 @@
+#include "CellKernel.h"
+#include "LineDomain.h"
+using namespace std;
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define CELLKERNEL_X86
+#include <immintrin.h>
+#endif
+
+#if defined(CELLKERNEL_X86) && !defined(_MSC_VER)
+#define AVX2_TARGET __attribute__((target("avx2"))) //only this function is built for avx2, the rest runs anywhere
+#else
+#define AVX2_TARGET //msvc accepts the intrinsics without a flag
+#endif
+
+//bit i set where candidate i of the block has the cell filled, the block's first candidate at lines
+static uint64_t scalarBlock(const uint64_t* lines, int words, int candidates, int cell)
+{
+	const uint64_t* word = lines + (cell >> 6);
+	int bit = cell & 63;
+	uint64_t bits = 0;
+	for (int i = 0; i < candidates; i++)
+		bits |= ((word[(size_t)i * words] >> bit) & 1) << i;
+	return bits;
+}
+
+//the same, only looking at the candidates in live, cheaper than either when a search has removed most of the block
+static uint64_t sparseBlock(const uint64_t* lines, int words, uint64_t live, int cell)
+{
+	const uint64_t* word = lines + (cell >> 6);
+	int bit = cell & 63;
+	uint64_t bits = 0;
+	for (; live != 0; live &= live - 1)
+	{
+		int i = countTrailingZeros(live);
+		bits |= ((word[(size_t)i * words] >> bit) & 1) << i;
+	}
+	return bits;
+}
+
+#ifdef CELLKERNEL_X86
+//the same for a full block of 64 candidates, four at a time: the cell is shifted into the sign bit and the signs collected
+AVX2_TARGET static uint64_t avx2Block(const uint64_t* lines, int words, int cell)
+{
+	const uint64_t* word = lines + (cell >> 6);
+	__m128i shift = _mm_cvtsi32_si128(63 - (cell & 63));
+	uint64_t bits = 0;
+	if (words == 1) //candidates are contiguous, plain loads
+		for (int i = 0; i < 64; i += 4)
+		{
+			__m256i packed = _mm256_loadu_si256((const __m256i*)(word + i));
+			bits |= (uint64_t)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_sll_epi64(packed, shift))) << i;
+		}
+	else //one word per candidate, words apart
+	{
+		__m256i offsets = _mm256_set_epi64x(3LL * words, 2LL * words, words, 0);
+		for (int i = 0; i < 64; i += 4)
+		{
+			__m256i packed = _mm256_i64gather_epi64((const long long*)(word + (size_t)i * words), offsets, 8);
+			bits |= (uint64_t)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_sll_epi64(packed, shift))) << i;
+		}
+	}
+	return bits;
+}
+#endif
+
+bool avx2Supported()
+{
+#if defined(CELLKERNEL_X86) && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return false;
+	__cpuid(info, 1);
+	bool osSavesYmm = (info[2] & (1 << 27)) && (_xgetbv(0) & 6) == 6; //osxsave, then xmm and ymm state enabled
+	__cpuidex(info, 7, 0);
+	return osSavesYmm && (info[1] & (1 << 5));
+#elif defined(CELLKERNEL_X86)
+	__builtin_cpu_init(); //needed when called during static initialization
+	return __builtin_cpu_supports("avx2");
+#else
+	return false;
+#endif
+}
+
+static CellKernel kernel = avx2Supported() ? KERNEL_AVX2 : KERNEL_SCALAR;
+
+CellKernel activeCellKernel()
+{
+	return kernel;
+}
+
+void setCellKernel(CellKernel choice)
+{
+	kernel = choice == KERNEL_AVX2 && avx2Supported() ? KERNEL_AVX2 : KERNEL_SCALAR;
+}
+
+static const int sparseLimit = 8; //live candidates in a block below which only they are read
+
+int selectCell(const uint64_t* lines, int words, int count, const uint64_t* live, int liveWords, int cell, bool filled, uint64_t* selected)
+{
+	int total = 0;
+	for (int block = 0; block < liveWords; block++)
+	{
+		uint64_t bits = 0;
+		if (live[block] != 0) //blocks without live candidates are not read at all
+		{
+			const uint64_t* first = lines + (size_t)block * 64 * words;
+			int candidates = count - block * 64 < 64 ? count - block * 64 : 64;
+			if (countBits(live[block]) <= sparseLimit)
+				bits = sparseBlock(first, words, live[block], cell);
+#ifdef CELLKERNEL_X86
+			else if (kernel == KERNEL_AVX2 && candidates == 64)
+				bits = avx2Block(first, words, cell);
+#endif
+			else
+				bits = scalarBlock(first, words, candidates, cell);
+			bits = (filled ? bits : ~bits) & live[block];
+			total += countBits(bits);
+		}
+		if (selected)
+			selected[block] = bits;
+	}
+	return total;
+}
@@ -0,0 +1,38 @@
+//picking out the candidates of a domain by the value of one cell, with an avx2 path chosen at runtime
+#ifndef CELLKERNEL_H
+#define CELLKERNEL_H
+
+#include <cstdint>
+using std::uint64_t;
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+enum CellKernel
+{
+	KERNEL_SCALAR,
+	KERNEL_AVX2
+};
+
+bool avx2Supported(); //the cpu and the os both handle 256 bit registers
+CellKernel activeCellKernel();
+void setCellKernel(CellKernel kernel); //falls back to scalar when avx2 is asked for but not supported, for benchmarks
+
+inline int countBits(uint64_t word)
+{
+#if defined(_MSC_VER) && defined(_WIN64)
+	return (int)__popcnt64(word);
+#elif defined(_MSC_VER)
+	return (int)(__popcnt((unsigned int)word) + __popcnt((unsigned int)(word >> 32)));
+#else
+	return __builtin_popcountll(word);
+#endif
+}
+
+//candidates are packed like LineDomain stores them, candidate i at words [i * words, (i + 1) * words). for every live
+//candidate (bit i of live) whose cell equals filled, sets bit i of selected (liveWords words, may be null to only count).
+//returns how many were selected
+int selectCell(const uint64_t* lines, int words, int count, const uint64_t* live, int liveWords, int cell, bool filled, uint64_t* selected);
+
+#endif
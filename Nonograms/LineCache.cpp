@@ -0,0 +1,107 @@
+#include "LineCache.h"
+#include "LineSolver.h"
+#include <functional>
+using namespace std;
+
+LineCache::LineCache(size_t slotCount) : hits(0), misses(0), evictions(0), enabled(true)
+{
+	size_t size = 1;
+	while (size < slotCount)
+		size <<= 1;
+	slots.resize(size);
+	mask = size - 1;
+}
+
+LineCache& LineCache::shared()
+{
+	static LineCache cache;
+	return cache;
+}
+
+//false if a number does not fit the 16 bit key, those lines skip the cache
+static bool buildKey(const vector<int>& clue, const vector<char>& line, string& key)
+{
+	if (line.empty() || line.size() > 0xFFFF) //an empty result means unsolvable, so empty lines are not stored
+		return false;
+	key.clear();
+	key.push_back((char)(line.size() & 0xFF)); //the length fixes how many bytes of cells end the key, so keys cannot run together
+	key.push_back((char)(line.size() >> 8));
+	for (int block : clue)
+	{
+		if (block > 0xFFFF)
+			return false;
+		key.push_back((char)(block & 0xFF));
+		key.push_back((char)(block >> 8));
+	}
+	unsigned char packed = 0;
+	for (size_t i = 0; i < line.size(); i++)
+	{
+		packed |= (line[i] == '-' ? 1 : line[i] == 'X' ? 2 : 0) << (i % 4 * 2);
+		if (i % 4 == 3)
+		{
+			key.push_back((char)packed);
+			packed = 0;
+		}
+	}
+	if (line.size() % 4 != 0)
+		key.push_back((char)packed);
+	return true;
+}
+
+bool LineCache::solve(const vector<int>& clue, vector<char>& line)
+{
+	static thread_local string key; //reused, so a lookup does not allocate
+	if (!enabled || !buildKey(clue, line, key))
+		return solveLine(clue, line);
+
+	uint64_t hash = std::hash<string>()(key);
+	size_t index = hash & mask;
+	Slot& slot = slots[index];
+	{
+		lock_guard<mutex> guard(locks[index % lockCount]);
+		if (slot.used && slot.hash == hash && slot.key == key)
+		{
+			hits.fetch_add(1, memory_order_relaxed);
+			if (slot.result.empty())
+				return false;
+			line.assign(slot.result.begin(), slot.result.end());
+			return true;
+		}
+	}
+	misses.fetch_add(1, memory_order_relaxed);
+
+	bool solvable = solveLine(clue, line); //outside the lock, other threads can use the slot meanwhile
+
+	lock_guard<mutex> guard(locks[index % lockCount]);
+	if (slot.used && !(slot.hash == hash && slot.key == key))
+		evictions.fetch_add(1, memory_order_relaxed);
+	slot.used = true;
+	slot.hash = hash;
+	slot.key = key; //assign keeps the slot's storage when it is big enough
+	if (solvable)
+		slot.result.assign(line.begin(), line.end());
+	else
+		slot.result.clear();
+	return solvable;
+}
+
+LineCacheStats LineCache::stats() const
+{
+	LineCacheStats result;
+	result.hits = hits.load();
+	result.misses = misses.load();
+	result.evictions = evictions.load();
+	return result;
+}
+
+void LineCache::clear()
+{
+	for (size_t i = 0; i < slots.size(); i++)
+	{
+		lock_guard<mutex> guard(locks[i % lockCount]);
+		slots[i].used = false;
+	}
+	hits = 0;
+	misses = 0;
+	evictions = 0;
+}
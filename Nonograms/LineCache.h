@@ -0,0 +1,54 @@
+//a bounded memo of solveLine results keyed by the clue and the known cells, shared by every solver thread
+#ifndef LINECACHE_H
+#define LINECACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+using std::atomic;
+using std::string;
+using std::uint64_t;
+using std::vector;
+
+struct LineCacheStats
+{
+	uint64_t hits = 0;
+	uint64_t misses = 0;
+	uint64_t evictions = 0; //results replaced by a different line landing in the same slot
+};
+
+class LineCache
+{
+	public:
+		static const size_t defaultSlots = 1 << 16;
+		explicit LineCache(size_t slots = defaultSlots); //rounded up to a power of two, each slot holds one line
+
+		//solveLine, answered from the cache when the same clue and known cells were solved before
+		bool solve(const vector<int>& clue, vector<char>& line);
+
+		LineCacheStats stats() const;
+		void clear(); //drops every result and zeroes the counters
+		void setEnabled(bool enable) { enabled = enable; } //off, solve always runs solveLine
+		bool isEnabled() const { return enabled; }
+
+		static LineCache& shared(); //the cache lineConsistency goes through, so puzzles of a batch share it
+	private:
+		struct Slot
+		{
+			uint64_t hash = 0;
+			string key; //the clue as 16 bit numbers then the known cells at 2 bits each
+			string result; //the solved line, empty when the clue cannot be placed
+			bool used = false;
+		};
+		static const int lockCount = 64; //slot i is guarded by locks[i % lockCount]
+
+		vector<Slot> slots;
+		size_t mask;
+		std::mutex locks[lockCount];
+		atomic<uint64_t> hits, misses, evictions;
+		atomic<bool> enabled;
+};
+
+#endif
@@ -0,0 +1,179 @@
+#include "LineDomain.h"
+#include "CellKernel.h"
+#include <algorithm>
+using namespace std;
+
+LineDomain::LineDomain(int length)
+{
+	lineLength = length;
+	words = (length + 63) / 64;
+	if (words == 0)
+		words = 1; //a zero length line still needs storage to be indexed
+	lines = allocate_shared<ArenaVector<uint64_t>>(ArenaAllocator<uint64_t>());
+}
+
+void LineDomain::addLine(const vector<char>& line)
+{
+	if (!lines)
+		lines = allocate_shared<ArenaVector<uint64_t>>(ArenaAllocator<uint64_t>());
+	else if (lines.use_count() > 1) //candidates are shared with a copy, detach before appending
+		lines = allocate_shared<ArenaVector<uint64_t>>(ArenaAllocator<uint64_t>(), *lines);
+
+	lines->resize(lines->size() + words, 0);
+	uint64_t* packed = lines->data() + (size_t)lineCount * words;
+	for (int cell = 0; cell < lineLength; cell++)
+		if (line[cell] == 'X')
+			packed[cell >> 6] |= uint64_t(1) << (cell & 63);
+
+	if ((lineCount & 63) == 0) //new word of the live mask
+		live.push_back(0);
+	live[lineCount >> 6] |= uint64_t(1) << (lineCount & 63);
+	lineCount++;
+	liveCount++;
+}
+
+void LineDomain::remove(int i)
+{
+	if (!isLive(i))
+		return;
+	live[i >> 6] &= ~(uint64_t(1) << (i & 63));
+	liveCount--;
+}
+
+void LineDomain::restore(int i)
+{
+	if (isLive(i))
+		return;
+	live[i >> 6] |= uint64_t(1) << (i & 63);
+	liveCount++;
+}
+
+void LineDomain::assign(int i)
+{
+	for (uint64_t& word : live)
+		word = 0;
+	live[i >> 6] = uint64_t(1) << (i & 63);
+	liveCount = 1;
+}
+
+//the first set bit after i of a mask of maskWords words, -1 if there is none
+static int nextSet(const uint64_t* mask, int maskWords, int i)
+{
+	i++;
+	int wordIndex = i >> 6;
+	if (wordIndex >= maskWords)
+		return -1;
+
+	uint64_t word = mask[wordIndex] & (~uint64_t(0) << (i & 63)); //ignore candidates before i
+	while (word == 0)
+	{
+		wordIndex++;
+		if (wordIndex >= maskWords)
+			return -1;
+		word = mask[wordIndex];
+	}
+	return wordIndex * 64 + countTrailingZeros(word);
+}
+
+int LineDomain::next(int i) const
+{
+	return nextSet(live.data(), (int)live.size(), i);
+}
+
+int LineDomain::next(const vector<uint64_t>& mask, int i)
+{
+	return nextSet(mask.data(), (int)mask.size(), i);
+}
+
+int LineDomain::countCell(int cell, bool filled) const
+{
+	if (!lines)
+		return 0;
+	return ::selectCell(lines->data(), words, lineCount, live.data(), (int)live.size(), cell, filled, nullptr);
+}
+
+void LineDomain::selectCell(int cell, bool filled, vector<uint64_t>& selected) const
+{
+	selected.resize(live.size()); //kept by the caller between queries, so this rarely allocates
+	if (lines)
+		::selectCell(lines->data(), words, lineCount, live.data(), (int)live.size(), cell, filled, selected.data());
+	else
+		fill(selected.begin(), selected.end(), 0);
+}
+
+int LineDomain::removeCell(int cell, bool filled)
+{
+	static thread_local vector<uint64_t> selected;
+	selectCell(cell, filled, selected);
+	int removed = 0;
+	for (size_t w = 0; w < live.size(); w++)
+	{
+		removed += countBits(selected[w]);
+		live[w] &= ~selected[w];
+	}
+	liveCount -= removed;
+	return removed;
+}
+
+bool LineDomain::restrictTo(const vector<char>& known)
+{
+	ArenaFrame frame;
+	ArenaVector<uint64_t> knownFilled(words, 0), knownEmpty(words, 0);
+	for (int cell = 0; cell < lineLength; cell++)
+		if (known[cell] == 'X')
+			knownFilled[cell >> 6] |= uint64_t(1) << (cell & 63);
+		else if (known[cell] == '-')
+			knownEmpty[cell >> 6] |= uint64_t(1) << (cell & 63);
+
+	bool isRevised = false;
+	for (int i = first(); i != -1; i = next(i))
+	{
+		const uint64_t* line = getLine(i);
+		for (int w = 0; w < words; w++)
+			if ((line[w] & knownEmpty[w]) || (~line[w] & knownFilled[w]))
+			{
+				remove(i);
+				isRevised = true;
+				break;
+			}
+	}
+	return isRevised;
+}
+
+void LineDomain::fillForced(vector<char>& known) const
+{
+	if (empty())
+		return;
+	ArenaFrame frame;
+	ArenaVector<uint64_t> always(words, ~uint64_t(0)), ever(words, 0); //filled in every candidate, filled in some candidate
+	for (int i = first(); i != -1; i = next(i))
+	{
+		const uint64_t* line = getLine(i);
+		for (int w = 0; w < words; w++)
+		{
+			always[w] &= line[w];
+			ever[w] |= line[w];
+		}
+	}
+	for (int cell = 0; cell < lineLength; cell++)
+		if ((always[cell >> 6] >> (cell & 63)) & 1)
+			known[cell] = 'X';
+		else if (!((ever[cell >> 6] >> (cell & 63)) & 1))
+			known[cell] = '-';
+}
+
+vector<char> LineDomain::decode(int i) const
+{
+	vector<char> line(lineLength);
+	for (int cell = 0; cell < lineLength; cell++)
+		line[cell] = getCell(i, cell);
+	return line;
+}
+
+size_t LineDomain::memoryUsage() const
+{
+	size_t bytes = sizeof(LineDomain) + live.capacity() * sizeof(uint64_t);
+	if (lines)
+		bytes += lines->capacity() * sizeof(uint64_t);
+	return bytes;
+}
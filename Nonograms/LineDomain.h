@@ -0,0 +1,82 @@
+//the domain of a row or column, every candidate line packed into 64 bit words
+#ifndef LINEDOMAIN_H
+#define LINEDOMAIN_H
+
+#include "Arena.h"
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <vector>
+using std::vector;
+using std::shared_ptr;
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+inline int countTrailingZeros(uint64_t word) //index of the lowest set bit, word must not be 0
+{
+#if defined(_MSC_VER) && defined(_WIN64)
+	unsigned long index;
+	_BitScanForward64(&index, word);
+	return (int)index;
+#elif defined(_MSC_VER) //32 bit msvc has no 64 bit scan
+	unsigned long index;
+	if (_BitScanForward(&index, (unsigned long)word))
+		return (int)index;
+	_BitScanForward(&index, (unsigned long)(word >> 32));
+	return (int)index + 32;
+#else
+	return __builtin_ctzll(word);
+#endif
+}
+
+class LineDomain
+{
+	public:
+		LineDomain() {}
+		explicit LineDomain(int length); //empty domain for lines of the given length
+
+		//candidates are immutable once added, copies of a domain share them and only copy the live mask. both come from the
+		//arena of the solve building or copying the domain, the heap outside of one
+		void addLine(const vector<char>& line); //pack a decoded line ('X' filled) and append it as a live candidate
+
+		int length() const { return lineLength; }
+		int size() const { return liveCount; } //live candidates
+		int totalSize() const { return lineCount; } //live and removed candidates
+		bool empty() const { return liveCount == 0; }
+
+		bool isLive(int i) const { return (live[i >> 6] >> (i & 63)) & 1; }
+		bool isFilled(int i, int cell) const { return ((*lines)[(size_t)i * words + (cell >> 6)] >> (cell & 63)) & 1; }
+		char getCell(int i, int cell) const { return isFilled(i, cell) ? 'X' : ' '; }
+		const uint64_t* getLine(int i) const { return lines->data() + (size_t)i * words; } //packed words of a candidate
+
+		void remove(int i); //take candidate i out of the domain
+		void restore(int i); //put a removed candidate back
+		void assign(int i); //remove every candidate but i
+
+		int first() const { return next(-1); } //first live candidate, -1 if there are none
+		int next(int i) const; //next live candidate after i, -1 if there are none
+		static int next(const vector<uint64_t>& mask, int i); //the same over a mask from selectCell
+
+		//known cells use the grid marks ' ' unknown, '-' empty, 'X' filled
+		bool restrictTo(const vector<char>& known); //remove candidates disagreeing with a known cell, true if any were removed
+		void fillForced(vector<char>& known) const; //mark the cells every live candidate agrees on
+
+		//bulk queries on one cell through selectCell
+		int countCell(int cell, bool filled) const; //live candidates with the cell filled, or empty
+		void selectCell(int cell, bool filled, vector<uint64_t>& selected) const; //those candidates as a mask shaped like live
+		int removeCell(int cell, bool filled); //remove those candidates, returns how many
+
+		vector<char> decode(int i) const; //unpack a candidate back into ' ' and 'X'
+		size_t memoryUsage() const; //bytes owned by the domain, shared candidates included
+	private:
+		int lineLength = 0;
+		int words = 0; //64 bit words per candidate
+		int lineCount = 0;
+		int liveCount = 0;
+		shared_ptr<ArenaVector<uint64_t>> lines; //candidate i occupies words [i * words, (i + 1) * words)
+		ArenaVector<uint64_t> live; //bit i is set while candidate i is in the domain
+};
+
+#endif
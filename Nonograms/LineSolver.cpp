@@ -0,0 +1,369 @@
+#include "LineSolver.h"
+#include "LineCache.h"
+#include "Arena.h"
+#include <algorithm>
+using namespace std;
+
+bool solveLine(const vector<int>& clue, vector<char>& line)
+{
+	int length = line.size();
+	int blocks = clue.size();
+	int stride = blocks + 1;
+	ArenaFrame frame; //the tables are gone once the line is solved
+
+	ArenaVector<int> emptyBefore(length + 1, 0); //emptyBefore[i] known empty cells in [0, i), a block fits [s, e) if none are there
+	for (int i = 0; i < length; i++)
+		emptyBefore[i + 1] = emptyBefore[i] + (line[i] == '-');
+	auto blockFits = [&](int start, int end) { return start >= 0 && end <= length && emptyBefore[end] == emptyBefore[start]; };
+
+	//prefix[i * stride + j] cells [0, i) can hold exactly the first j blocks, suffix[i * stride + j] cells [i, length) can
+	//hold blocks j and on
+	ArenaVector<char> prefix((length + 1) * stride, false);
+	ArenaVector<char> suffix((length + 1) * stride, false);
+	prefix[0] = true;
+	for (int i = 1; i <= length; i++)
+		for (int j = 0; j <= blocks; j++)
+		{
+			bool possible = line[i - 1] != 'X' && prefix[(i - 1) * stride + j]; //cell i - 1 left empty
+			if (!possible && j > 0 && blockFits(i - clue[j - 1], i)) //block j - 1 ends at cell i - 1
+			{
+				int start = i - clue[j - 1];
+				if (start == 0)
+					possible = j == 1;
+				else
+					possible = line[start - 1] != 'X' && prefix[(start - 1) * stride + j - 1];
+			}
+			prefix[i * stride + j] = possible;
+		}
+	if (!prefix[length * stride + blocks])
+		return false;
+
+	suffix[length * stride + blocks] = true;
+	for (int i = length - 1; i >= 0; i--)
+		for (int j = blocks; j >= 0; j--)
+		{
+			bool possible = line[i] != 'X' && suffix[(i + 1) * stride + j];
+			if (!possible && j < blocks && blockFits(i, i + clue[j]))
+			{
+				int end = i + clue[j];
+				if (end == length)
+					possible = j + 1 == blocks;
+				else
+					possible = line[end] != 'X' && suffix[(end + 1) * stride + j + 1];
+			}
+			suffix[i * stride + j] = possible;
+		}
+
+	//a cell can be empty if the blocks split around it, it can be filled if some valid placement of a block covers it
+	ArenaVector<int> cover(length + 1, 0); //difference array of valid block placements
+	for (int j = 0; j < blocks; j++)
+		for (int start = 0; start + clue[j] <= length; start++)
+		{
+			int end = start + clue[j];
+			if (!blockFits(start, end))
+				continue;
+			bool before = start == 0 ? j == 0 : line[start - 1] != 'X' && prefix[(start - 1) * stride + j];
+			bool after = end == length ? j + 1 == blocks : line[end] != 'X' && suffix[(end + 1) * stride + j + 1];
+			if (before && after)
+			{
+				cover[start]++;
+				cover[end]--;
+			}
+		}
+
+	int covered = 0;
+	for (int i = 0; i < length; i++)
+	{
+		covered += cover[i];
+		bool canFill = covered > 0;
+		bool canEmpty = false;
+		for (int j = 0; j <= blocks && !canEmpty; j++)
+			canEmpty = line[i] != 'X' && prefix[i * stride + j] && suffix[(i + 1) * stride + j];
+
+		if (!canFill && !canEmpty)
+			return false;
+		if (!canEmpty)
+			line[i] = 'X';
+		else if (!canFill)
+			line[i] = '-';
+	}
+	return true;
+}
+
+double countPlacements(const vector<int>& clue, const vector<char>& line)
+{
+	int length = line.size();
+	int blocks = clue.size();
+	int stride = blocks + 1;
+	ArenaFrame frame;
+
+	ArenaVector<int> emptyBefore(length + 1, 0);
+	for (int i = 0; i < length; i++)
+		emptyBefore[i + 1] = emptyBefore[i] + (line[i] == '-');
+
+	//ways[i * stride + j] placements of the first j blocks in cells [0, i), doubles since wide lines overflow 64 bit counts
+	ArenaVector<double> ways((length + 1) * stride, 0);
+	ways[0] = 1;
+	for (int i = 1; i <= length; i++)
+		for (int j = 0; j <= blocks; j++)
+		{
+			double count = line[i - 1] != 'X' ? ways[(i - 1) * stride + j] : 0; //cell i - 1 left empty
+			int start = j > 0 ? i - clue[j - 1] : -1;
+			if (j > 0 && start >= 0 && emptyBefore[i] == emptyBefore[start]) //or block j - 1 ends at cell i - 1
+			{
+				if (start == 0)
+					count += j == 1;
+				else if (line[start - 1] != 'X')
+					count += ways[(start - 1) * stride + j - 1];
+			}
+			ways[i * stride + j] = count;
+		}
+	return ways[length * stride + blocks];
+}
+
+typedef ArenaVector<ArenaVector<char>> ScratchGrid; //grid copies made while probing and guessing, from the solve's arena
+
+//the grid functions below run on the caller's grid and on scratch grids alike
+template <typename Grid>
+static ScratchGrid scratchCopy(const Grid& grid)
+{
+	ScratchGrid copy;
+	copy.reserve(grid.size());
+	for (const auto& column : grid)
+		copy.emplace_back(column.begin(), column.end());
+	return copy;
+}
+
+template <typename Grid, typename Source>
+static void copyCells(Grid& grid, const Source& source) //same sized grids, so nothing is allocated
+{
+	for (size_t x = 0; x < grid.size(); x++)
+		copy(source[x].begin(), source[x].end(), grid[x].begin());
+}
+
+template <typename Grid, typename Queue>
+static bool propagateLines(const Nonogram& n, Grid& grid, Queue& rowQueued, Queue& columnQueued)
+{
+	int w = n.getWidth();
+	int h = n.getHeight();
+	bool changed = true;
+	static thread_local vector<char> line; //the cache takes plain lines, kept between calls so it rarely allocates
+	while (changed)
+	{
+		changed = false;
+		for (int y = 0; y < h; y++)
+		{
+			if (!rowQueued[y])
+				continue;
+			rowQueued[y] = false;
+			line.resize(w);
+			for (int x = 0; x < w; x++)
+				line[x] = grid[x][y];
+			if (!LineCache::shared().solve(n.getRow(y), line))
+				return false;
+			for (int x = 0; x < w; x++)
+				if (line[x] != grid[x][y]) //a newly known cell dirties its column
+				{
+					grid[x][y] = line[x];
+					columnQueued[x] = true;
+					changed = true;
+				}
+		}
+		for (int x = 0; x < w; x++)
+		{
+			if (!columnQueued[x])
+				continue;
+			columnQueued[x] = false;
+			line.assign(grid[x].begin(), grid[x].end());
+			if (!LineCache::shared().solve(n.getColumn(x), line))
+				return false;
+			for (int y = 0; y < h; y++)
+				if (line[y] != grid[x][y])
+				{
+					grid[x][y] = line[y];
+					rowQueued[y] = true;
+					changed = true;
+				}
+		}
+	}
+	return true;
+}
+
+bool lineConsistency(const Nonogram& n, vector<vector<char>>& grid)
+{
+	ArenaFrame frame;
+	ArenaVector<bool> rowQueued(n.getHeight(), true); //every line starts dirty
+	ArenaVector<bool> columnQueued(n.getWidth(), true);
+	return propagateLines(n, grid, rowQueued, columnQueued);
+}
+
+bool lineConsistency(const Nonogram& n, vector<vector<char>>& grid, vector<bool>& rowQueued, vector<bool>& columnQueued)
+{
+	return propagateLines(n, grid, rowQueued, columnQueued);
+}
+
+template <typename Grid>
+static bool probe(const Nonogram& n, Grid& grid, SearchStats& stats);
+template <typename Grid>
+static long long guessCells(const Nonogram& n, Grid& grid, long long limit, SearchStats& stats);
+
+bool lineSearch(const Nonogram& n, vector<vector<char>>& grid)
+{
+	SearchStats stats;
+	return lineSearch(n, grid, stats);
+}
+
+bool lineSearch(const Nonogram& n, vector<vector<char>>& grid, SearchStats& stats)
+{
+	return lineConsistency(n, grid) && probe(n, grid, stats) && guessCells(n, grid, 1, stats) == 1;
+}
+
+long long countLineSolutions(const Nonogram& n, vector<vector<char>>& grid, long long limit, SearchStats& stats)
+{
+	return lineConsistency(n, grid) && probe(n, grid, stats) ? guessCells(n, grid, limit, stats) : 0;
+}
+
+template <typename Grid>
+static long long unknownCells(const Grid& grid)
+{
+	long long unknown = 0;
+	for (const auto& column : grid)
+		unknown += count(column.begin(), column.end(), ' ');
+	return unknown;
+}
+
+bool probeCells(const Nonogram& n, vector<vector<char>>& grid, SearchStats& stats)
+{
+	return probe(n, grid, stats);
+}
+
+template <typename Grid>
+static bool probe(const Nonogram& n, Grid& grid, SearchStats& stats)
+{
+	if (stats.probeLimit <= 0)
+		return true;
+	int w = n.getWidth();
+	int h = n.getHeight();
+	int cells = w * h;
+	long long probes = 0;
+	int unchanged = 0; //cells passed since one last settled anything, a whole round of them ends probing
+	for (int cell = 0; unchanged < cells && probes < stats.probeLimit; cell = (cell + 1) % cells, unchanged++)
+	{
+		int x = cell / h, y = cell % h;
+		if (grid[x][y] != ' ')
+			continue;
+		probes++;
+		stats.probes++;
+		ArenaFrame frame; //both branches are dropped once the probe is settled
+		ScratchGrid branch[2] = { scratchCopy(grid), scratchCopy(grid) };
+		bool consistent[2];
+		for (int value = 0; value < 2; value++)
+		{
+			branch[value][x][y] = value == 0 ? 'X' : '-';
+			ArenaVector<bool> rowQueued(h, false), columnQueued(w, false);
+			rowQueued[y] = true;
+			columnQueued[x] = true;
+			consistent[value] = propagateLines(n, branch[value], rowQueued, columnQueued);
+		}
+		if (!consistent[0] && !consistent[1])
+			return false;
+
+		long long before = unknownCells(grid);
+		if (consistent[0] != consistent[1]) //the value that contradicted can never hold, the other branch is already solved out
+			copyCells(grid, branch[consistent[0] ? 0 : 1]);
+		else
+		{
+			ArenaVector<bool> rowQueued(h, false), columnQueued(w, false);
+			for (int i = 0; i < w; i++)
+				for (int j = 0; j < h; j++)
+					if (grid[i][j] == ' ' && branch[0][i][j] != ' ' && branch[0][i][j] == branch[1][i][j]) //either way the cell ends up the same
+					{
+						grid[i][j] = branch[0][i][j];
+						rowQueued[j] = true;
+						columnQueued[i] = true;
+					}
+			if (!propagateLines(n, grid, rowQueued, columnQueued))
+				return false;
+		}
+		long long after = unknownCells(grid);
+		if (after < before)
+		{
+			stats.settled += before - after;
+			unchanged = 0;
+		}
+	}
+	return true;
+}
+
+//grid is already line consistent, guess the unknown cell whose row and column have the fewest unknowns left.
+//solutions found up to limit, grid is left holding the one that reached the limit
+template <typename Grid>
+static long long guessCells(const Nonogram& n, Grid& grid, long long limit, SearchStats& stats)
+{
+	int w = n.getWidth();
+	int h = n.getHeight();
+	ArenaFrame frame; //a node's scratch goes back when the search leaves it
+	ArenaVector<int> rowUnknown(h, 0), columnUnknown(w, 0);
+	for (int x = 0; x < w; x++)
+		for (int y = 0; y < h; y++)
+			if (grid[x][y] == ' ')
+			{
+				rowUnknown[y]++;
+				columnUnknown[x]++;
+			}
+
+	int guessX = -1, guessY = -1;
+	int fewest = w + h + 1;
+	for (int x = 0; x < w; x++)
+		for (int y = 0; y < h; y++)
+			if (grid[x][y] == ' ' && min(rowUnknown[y], columnUnknown[x]) < fewest)
+			{
+				guessX = x;
+				guessY = y;
+				fewest = min(rowUnknown[y], columnUnknown[x]);
+			}
+	if (guessX == -1) //every cell known and every line consistent
+		return 1;
+	if (stats.limitReached())
+		return 0;
+	stats.nodes++;
+
+	long long found = 0;
+	for (char guess : { 'X', '-' })
+	{
+		ArenaFrame guessFrame;
+		ScratchGrid guessGrid = scratchCopy(grid);
+		guessGrid[guessX][guessY] = guess;
+		ArenaVector<bool> rowQueued(h, false), columnQueued(w, false); //only the guessed cell's lines are dirty
+		rowQueued[guessY] = true;
+		columnQueued[guessX] = true;
+		if (propagateLines(n, guessGrid, rowQueued, columnQueued) && probe(n, guessGrid, stats))
+			found += guessCells(n, guessGrid, limit - found, stats);
+		if (found >= limit)
+		{
+			copyCells(grid, guessGrid);
+			break;
+		}
+		if (stats.limitReached())
+			break;
+	}
+	return found;
+}
+
+bool solveByLines(Nonogram& n)
+{
+	SearchStats stats;
+	return solveByLines(n, stats);
+}
+
+bool solveByLines(Nonogram& n, SearchStats& stats)
+{
+	vector<vector<char>> grid(n.getWidth(), vector<char>(n.getHeight(), ' '));
+	if (!lineSearch(n, grid, stats))
+		return false;
+
+	for (int x = 0; x < n.getWidth(); x++)
+		for (int y = 0; y < n.getHeight(); y++)
+			n[x][y] = grid[x][y] == 'X' ? 'X' : ' '; //solutions leave empty cells blank like the domain solver
+	return true;
+}
@@ -0,0 +1,34 @@
+//solving lines from their clue and known cells, without enumerating candidate lines
+#ifndef LINESOLVER_H
+#define LINESOLVER_H
+
+#include "Nonogram.h"
+#include "Solver.h"
+#include <vector>
+using std::vector;
+
+//cells use the grid marks: ' ' unknown, '-' known empty, 'X' known filled
+//fills in every cell that has the same value in all placements of the clue, false if the clue cannot be placed at all
+bool solveLine(const vector<int>& clue, vector<char>& line);
+double countPlacements(const vector<int>& clue, const vector<char>& line); //placements of the clue that agree with the known cells
+
+//solve every row and column of the grid until nothing changes, false on a contradiction. grid[x][y] like Nonogram.
+//lines go through LineCache::shared()
+bool lineConsistency(const Nonogram& n, vector<vector<char>>& grid);
+bool lineConsistency(const Nonogram& n, vector<vector<char>>& grid, vector<bool>& rowQueued, vector<bool>& columnQueued); //only the queued lines start dirty
+
+//tries both values of each unknown cell with lineConsistency, up to stats.probeLimit cells a pass. a value that
+//contradicts fixes the other and cells both values settle alike are fixed, passes repeat while they settle cells.
+//false when both values of a cell contradict
+bool probeCells(const Nonogram& n, vector<vector<char>>& grid, SearchStats& stats);
+
+//depth first search over unknown cells with lineConsistency after every guess, false if there is no solution
+bool lineSearch(const Nonogram& n, vector<vector<char>>& grid);
+bool lineSearch(const Nonogram& n, vector<vector<char>>& grid, SearchStats& stats); //counts guessed cells as nodes, false once the limit is reached
+//the same search through every branch, solutions up to limit. grid holds the last one only if the limit was reached
+long long countLineSolutions(const Nonogram& n, vector<vector<char>>& grid, long long limit, SearchStats& stats);
+
+bool solveByLines(Nonogram& n); //lineSearch from an empty grid, writes the solution into n
+bool solveByLines(Nonogram& n, SearchStats& stats);
+
+#endif
@@ -0,0 +1,103 @@
+#include "MemoryTracker.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+using namespace std;
+
+static atomic<bool> timing(false);
+
+void setAllocationTiming(bool on) { timing = on; }
+bool allocationTiming() { return timing.load(memory_order_relaxed); }
+
+#ifdef NONOGRAMS_TRACK_MEMORY
+
+//every block is prefixed with its size so delete can subtract it, the header keeps the default alignment
+static const size_t headerSize = alignof(max_align_t) > sizeof(size_t) ? alignof(max_align_t) : sizeof(size_t);
+
+static atomic<size_t> bytesInUse(0);
+static atomic<size_t> bytesPeak(0);
+static atomic<size_t> allocations(0);
+static atomic<long long> allocatorTime(0);
+
+//adds the time from start to the allocator time when timing is on
+class AllocatorTimer
+{
+	public:
+		AllocatorTimer() : timed(timing.load(memory_order_relaxed))
+		{
+			if (timed)
+				start = chrono::steady_clock::now();
+		}
+		~AllocatorTimer()
+		{
+			if (timed)
+				allocatorTime.fetch_add(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count(), memory_order_relaxed);
+		}
+	private:
+		bool timed;
+		chrono::steady_clock::time_point start;
+};
+
+static void* trackedAllocate(size_t size)
+{
+	AllocatorTimer timer;
+	void* block = malloc(size + headerSize);
+	if (!block)
+		throw bad_alloc();
+	*(size_t*)block = size;
+
+	allocations.fetch_add(1, memory_order_relaxed);
+	size_t used = bytesInUse.fetch_add(size, memory_order_relaxed) + size;
+	size_t peak = bytesPeak.load(memory_order_relaxed);
+	while (used > peak && !bytesPeak.compare_exchange_weak(peak, used, memory_order_relaxed)); //raise the peak if we passed it
+	return (char*)block + headerSize;
+}
+
+static void trackedFree(void* pointer)
+{
+	if (!pointer)
+		return;
+	AllocatorTimer timer;
+	void* block = (char*)pointer - headerSize;
+	bytesInUse.fetch_sub(*(size_t*)block, memory_order_relaxed);
+	free(block);
+}
+
+bool memoryTracked() { return true; }
+size_t currentMemory() { return bytesInUse.load(memory_order_relaxed); }
+size_t peakMemory() { return bytesPeak.load(memory_order_relaxed); }
+size_t allocationCount() { return allocations.load(memory_order_relaxed); }
+void resetPeakMemory() { bytesPeak.store(bytesInUse.load(memory_order_relaxed), memory_order_relaxed); }
+long long allocationNanoseconds() { return allocatorTime.load(memory_order_relaxed); }
+
+//global replacements, the sized and nothrow forms all route through the same pair
+void* operator new(size_t size) { return trackedAllocate(size); }
+void* operator new[](size_t size) { return trackedAllocate(size); }
+void* operator new(size_t size, const nothrow_t&) noexcept
+{
+	try { return trackedAllocate(size); }
+	catch (...) { return nullptr; }
+}
+void* operator new[](size_t size, const nothrow_t&) noexcept
+{
+	try { return trackedAllocate(size); }
+	catch (...) { return nullptr; }
+}
+void operator delete(void* pointer) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, size_t) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, const nothrow_t&) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, const nothrow_t&) noexcept { trackedFree(pointer); }
+
+#else
+
+bool memoryTracked() { return false; }
+size_t currentMemory() { return 0; }
+size_t peakMemory() { return 0; }
+size_t allocationCount() { return 0; }
+void resetPeakMemory() {}
+long long allocationNanoseconds() { return 0; }
+
+#endif
@@ -0,0 +1,21 @@
+//counts heap use of the whole program by replacing the global operator new and delete. the replacement puts a header on
+//every block and shared counters on every allocation, so it is only built with NONOGRAMS_TRACK_MEMORY defined (debug
+//builds). without it the counts and times below stay 0
+#ifndef MEMORYTRACKER_H
+#define MEMORYTRACKER_H
+
+#include <cstddef>
+
+bool memoryTracked(); //whether this build counts heap use at all
+size_t currentMemory(); //bytes currently allocated through operator new
+size_t peakMemory(); //most bytes allocated at once since the last resetPeakMemory()
+size_t allocationCount(); //calls to operator new since the program started
+void resetPeakMemory(); //start a new peak measurement from the current usage
+
+//time spent in operator new and delete when tracked, and in arenas made while it is on. off by default, the clock costs more than a
+//small allocation
+void setAllocationTiming(bool on);
+bool allocationTiming();
+long long allocationNanoseconds(); //heap allocator time since the program started
+
+#endif
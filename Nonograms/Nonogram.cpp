@@ -1,90 +1,29 @@
 #include "Nonogram.h"
+#include "PuzzleGenerator.h"
+#include <algorithm>
 #include <iomanip>
 using namespace std;
 
-Nonogram::Nonogram(int width, int height)
+Nonogram::Nonogram(int width, int height) : Nonogram(width, height, PuzzleGenerator::randomSeed())
 {
-	srand(time(0)); //set random seed to system time
+} //a new random puzzle on every call, even within the same second
 
+Nonogram::Nonogram(int width, int height, uint64_t seed, double density)
+{
 	w = width;
 	h = height;
-	column = new vector<int>[w]; //reserve vectors
-	row = new vector<int>[h];
-
-	grid = new char* [w]; //allocate the grid
-	for (int i = 0; i < w; i++)
-		grid[i] = new char[h];
-
-	//fill the grid randomly
-	for (int x = 0; x < w; x++)
-		for (int y = 0; y < h; y++)
-			grid[x][y] = 32 + 56 * (rand() % 2); //fill grid randomly, ' ' = 32, 'X' = 88, either ' ' or '@'
-
-	//determine the row and column vectors
-	for (int x = 0; x < w; x++) //fill the column vector
-	{
-		int streak = 0;
-		for (int y = 0; y < h; y++)
-		{
-			if (grid[x][y] == 'X')
-				streak++;
-			else if (streak > 0) //streak broken
-			{
-				column[x].push_back(streak);
-				streak = 0; //reset streak
-			}
-		}
-		if (streak != 0)
-			column[x].push_back(streak);
-	}
-	for (int y = 0; y < h; y++) //fill the row vector
-	{
-		int streak = 0;
-		for (int x = 0; x < w; x++)
-		{
-			if (grid[x][y] == 'X')
-				streak++;
-			else if (streak > 0) //streak broken
-			{
-				row[y].push_back(streak);
-				streak = 0; //reset streak
-			}
-		}
-		if (streak != 0)
-			row[y].push_back(streak);
-	}
-
-	/* reset the grid to an empty array, currently disabled
-	for (int x = 0; x < w; x++)
-		for (int y = 0; y < h; y++)
-			grid[x][y] = ' ';
-	//*/
-
-} //constructor, allocate and make random puzzle //default constructor
-
-Nonogram::Nonogram(const Nonogram& n) //copy constructor
-{
-	//copy over the size
-	w = n.w;
-	h = n.h;
-
-	column = new vector<int>[w]; //reserve vectors
-	row = new vector<int>[h];
 
-	grid = new char* [w]; //allocate the grid
-	for (int i = 0; i < w; i++)
-		grid[i] = new char[h];
-
-	for (int x = 0; x < w; x++) //copy the grid
-		for (int y = 0; y < h; y++)
-			grid[x][y] = n.grid[x][y];
-
-	//copy over the labels
-	for (int x = 0; x < w; x++)
-		column[x] = n.column[x];
+	//fill the grid randomly and label it
+	PuzzleGenerator generator(seed);
+	vector<uint64_t> bits;
+	generator.generate(w, h, density, bits, row, column);
+	int words = (w + 63) / 64;
+	cells.resize((size_t)w * h);
 	for (int y = 0; y < h; y++)
-		row[y] = n.row[y];
-}
+		for (int x = 0; x < w; x++)
+			cells[(size_t)y * w + x] = (bits[(size_t)y * words + x / 64] >> (x % 64) & 1) ? 'X' : ' ';
+	touchAll();
+} //the solution is left in the grid
 
 //construct from vector labels
 Nonogram::Nonogram(vector<vector<int>> rows, vector<vector<int>> columns)
@@ -93,61 +32,16 @@ Nonogram::Nonogram(vector<vector<int>> rows, vector<vector<int>> columns)
 	w = columns.size();
 	h = rows.size();
 
-	column = new vector<int>[w]; //reserve vectors
-	row = new vector<int>[h];
+	//a 0 label means an empty line, drop it so the labels match the streaks isSolved() builds
+	for (vector<int>& labels : columns)
+		labels.erase(remove(labels.begin(), labels.end(), 0), labels.end());
+	for (vector<int>& labels : rows)
+		labels.erase(remove(labels.begin(), labels.end(), 0), labels.end());
+	column = move(columns); //the parameters are our own copies, take their storage
+	row = move(rows);
 
-	for (int x = 0; x < w; x++)
-		column[x] = columns[x];
-	for (int y = 0; y < h; y++)
-		row[y] = rows[y];
-
-	grid = new char* [w]; //allocate the grid
-	for (int i = 0; i < w; i++)
-		grid[i] = new char[h];
-
-	for (int x = 0; x < w; x++) //set the grid to empty
-		for (int y = 0; y < h; y++)
-			grid[x][y] = ' ';
-}
-
-Nonogram::~Nonogram() //destructor
-{
-	for (int x = 0; x < w; x++)
-		delete grid[x];
-	delete grid;
-} //destructor
-
-//asssignment same as copy constructor
-Nonogram& Nonogram::operator=(const Nonogram& n)
-{
-	//check for assignment to the same var
-	if (this == &n)
-		return *this;
-
-	//do as the copy constructor would do
-	//copy over the size
-	w = n.w;
-	h = n.h;
-
-	column = new vector<int>[w]; //reserve vectors
-	row = new vector<int>[h];
-
-	grid = new char* [w]; //allocate the grid
-	for (int i = 0; i < w; i++)
-		grid[i] = new char[h];
-
-	for (int x = 0; x < w; x++) //copy the grid
-		for (int y = 0; y < h; y++)
-			grid[x][y] = n.grid[x][y];
-
-	//copy over the labels
-	for (int x = 0; x < w; x++)
-		column[x] = n.column[x];
-	for (int y = 0; y < h; y++)
-		row[y] = n.row[y];
-
-	//return the object in case another assignment
-	return *this;
+	cells.assign((size_t)w * h, ' '); //set the grid to empty
+	touchAll();
 }
 
 ostream& operator<<(ostream& outstream, const Nonogram& n) // print. for ease, the label numbers are printed on the bottom and left
@@ -159,7 +53,7 @@ ostream& operator<<(ostream& outstream, const Nonogram& n) // print. for ease, t
 	for (int y = 0; y < n.h; y++) // print row
 	{
 		for (int x = 0; x < n.w; x++) // print grid
-			outstream << n.grid[x][y] << ' '; // width is always 2
+			outstream << n.getCell(x, y) << ' '; // width is always 2
 		outstream << '|'; // grid and label seperator
 		for (int i = 0; i < n.row[y].size(); i++) // print row labels
 			outstream << n.row[y][i] << ' ';
@@ -182,62 +76,114 @@ ostream& operator<<(ostream& outstream, const Nonogram& n) // print. for ease, t
 
 void Nonogram::clearGrid() // reset the grid
 {
+	fill(cells.begin(), cells.end(), ' ');
+	touchAll();
+}
+
+vector<uint8_t> Nonogram::packCells() const
+{
+	vector<uint8_t> packed((cells.size() + 3) / 4, 0);
+	for (size_t i = 0; i < cells.size(); i++)
+	{
+		uint8_t code = cells[i] == '-' ? 1 : cells[i] == 'X' ? 2 : 0;
+		packed[i / 4] |= code << (i % 4 * 2);
+	}
+	return packed;
+}
+
+void Nonogram::unpackCells(const vector<uint8_t>& packed)
+{
+	static const char marks[] = { ' ', '-', 'X', ' ' };
+	for (size_t i = 0; i < cells.size() && i / 4 < packed.size(); i++)
+		cells[i] = marks[packed[i / 4] >> (i % 4 * 2) & 3];
+	touchAll();
+}
+
+void Nonogram::touch(int x, int y)
+{
+	if (rowState[y] != LINE_DIRTY)
+	{
+		mismatches -= rowState[y] == LINE_MISMATCHES;
+		rowState[y] = LINE_DIRTY;
+		dirtyRows.push_back(y);
+	}
+	if (columnState[x] != LINE_DIRTY)
+	{
+		mismatches -= columnState[x] == LINE_MISMATCHES;
+		columnState[x] = LINE_DIRTY;
+		dirtyColumns.push_back(x);
+	}
+}
+
+void Nonogram::touchAll()
+{
+	rowState.assign(h, LINE_DIRTY);
+	columnState.assign(w, LINE_DIRTY);
+	dirtyRows.resize(h);
+	for (int y = 0; y < h; y++)
+		dirtyRows[y] = y;
+	dirtyColumns.resize(w);
 	for (int x = 0; x < w; x++)
-		for (int y = 0; y < h; y++)
-			grid[x][y] = ' ';
+		dirtyColumns[x] = x;
+	mismatches = 0;
+}
+
+//compare the streaks of a line of cells with its labels as they are found, nothing is built
+static bool streaksMatch(const char* first, size_t stride, int length, const vector<int>& labels)
+{
+	size_t next = 0; //the label the current streak must equal
+	int streak = 0;
+	for (int i = 0; i <= length; i++)
+		if (i < length && first[i * stride] == 'X')
+		{
+			streak++;
+			if (next == labels.size() || streak > labels[next])
+				return false;
+		}
+		else if (streak > 0) //streak broken
+		{
+			if (streak != labels[next])
+				return false;
+			next++;
+			streak = 0; //reset streak
+		}
+	return next == labels.size();
 }
 
 bool Nonogram::isSolved() const
 {
-	//determine the row and column vectors
-	for (int x = 0; x < w; x++) //fill the column vector
+	if (mismatches > 0) //a line checked earlier and untouched since is still wrong
+		return false;
+
+	while (!dirtyRows.empty())
 	{
-		vector<int> columnV;
-		int streak = 0;
-		for (int y = 0; y < h; y++)
+		int y = dirtyRows.back();
+		dirtyRows.pop_back();
+		bool matches = streaksMatch(cells.data() + (size_t)y * w, 1, w, row[y]);
+		rowState[y] = matches ? LINE_MATCHES : LINE_MISMATCHES;
+		if (!matches)
 		{
-			if (grid[x][y] == 'X')
-				streak++;
-			else if (streak > 0) //streak broken
-			{
-				columnV.push_back(streak);
-				streak = 0; //reset streak
-			}
+			mismatches++;
+			return false; //the other dirty lines wait for the next call
 		}
-		if (streak != 0)
-			columnV.push_back(streak);
-		if (columnV != column[x])
-			return false;
 	}
-
-	for (int y = 0; y < h; y++) //fill the row vector
+	while (!dirtyColumns.empty())
 	{
-		vector<int> rowV;
-		int streak = 0;
-		for (int x = 0; x < w; x++)
+		int x = dirtyColumns.back();
+		dirtyColumns.pop_back();
+		bool matches = streaksMatch(cells.data() + x, w, h, column[x]);
+		columnState[x] = matches ? LINE_MATCHES : LINE_MISMATCHES;
+		if (!matches)
 		{
-			if (grid[x][y] == 'X')
-				streak++;
-			else if (streak > 0) //streak broken
-			{
-				rowV.push_back(streak);
-				streak = 0; //reset streak
-			}
-		}
-		if (streak != 0)
-			rowV.push_back(streak);
-		if (rowV != row[y])
+			mismatches++;
 			return false;
+		}
 	}
 	return true;
 }
 
-//careful with this, this assumes the boards are of the same dimensions, only checks the cells, this may crash if given incorrect sizes
-bool Nonogram::operator==(const Nonogram n) const
+//only checks the cells, boards of different sizes are never equal
+bool Nonogram::operator==(const Nonogram& n) const
 {
-	for (int x = 0; x < w; x++)
-		for (int y = 0; y < h; y++)
-			if (grid[x][y] != n.grid[x][y])
-				return false;
-	return true; //passed the test
+	return w == n.w && h == n.h && cells == n.cells; //passed the test
 }
\ No newline at end of file
@@ -2,39 +2,72 @@
 #ifndef NONOGRAM_H
 #define NONOGRAM_H
 
+#include <cstdint>
 #include <iostream>
 #include <vector>
+using std::uint64_t;
 using std::vector;
 using std::ostream;
 
 class Nonogram
 {
 	public:
-		Nonogram(int len, int wid); //constructor
-		Nonogram(vector<vector<int>> rows, vector<vector<int>> columns); //set constructor (from labels)
-		Nonogram(const Nonogram& n); //copy constructor
-		~Nonogram(); //destructor
-		
-		char* operator[](const int i) { return grid[i]; } //i.e. nono[2][3] = '-';
+		Nonogram(int len, int wid); //constructor, a random puzzle with its solution in the grid
+		Nonogram(int width, int height, uint64_t seed, double density = 0.5); //the same puzzle for the same seed, see PuzzleGenerator
+		Nonogram(vector<vector<int>> rows, vector<vector<int>> columns); //set constructor (from labels), pass with move to skip copying them
+		Nonogram(const Nonogram& n) = default; //the grid and labels are plain vectors, copies and moves just copy or move them
+		Nonogram(Nonogram&& n) noexcept = default;
+		~Nonogram() = default;
+
+		class Column //one column of the row major grid, so nono[x][y] still reads column first
+		{
+			public:
+				Column(Nonogram& n, int x) : n(n), x(x) {}
+				char& operator[](const int y) const { n.touch(x, y); return n.cells[(size_t)y * n.w + x]; } //may be written, so the lines are rechecked
+			private:
+				Nonogram& n;
+				int x;
+		};
+		Column operator[](const int i) { return Column(*this, i); } //i.e. nono[2][3] = '-';
+		char getCell(int x, int y) const { return cells[(size_t)y * w + x]; } //nono[x][y] on a const nonogram
 		
 		friend ostream& operator<<(ostream& outstream, const Nonogram& n); //print option
 
+		//only rows and columns touched through nono[x][y] since the last call are compared with their labels again, so a
+		//check after one move is O(width + height). the first mismatch ends it. not safe to call on one nonogram from two threads
 		bool isSolved() const;
-		Nonogram& operator=(const Nonogram& n);
-		bool operator==(const Nonogram n) const;
+		Nonogram& operator=(const Nonogram& n) = default;
+		Nonogram& operator=(Nonogram&& n) noexcept = default;
+		bool operator==(const Nonogram& n) const;
 
 		void clearGrid(); //remove the '-' and 'X' 's. 
 
+		//the grid at 2 bits a cell, 4 cells a byte row by row, for keeping many boards around. only ' ', '-' and 'X' survive,
+		//any other mark unpacks as ' '
+		vector<std::uint8_t> packCells() const;
+		void unpackCells(const vector<std::uint8_t>& packed);
+
 		int getWidth() const { return w; }
 		int getHeight() const { return h; }
-		vector<int> getColumn(int i) const { return column[i]; } //i.e. vector<int> numList = nono.getColumn(2);
-		vector<int> getRow(int i) const { return row[i]; }
+		const vector<int>& getColumn(int i) const { return column[i]; } //i.e. const vector<int>& numList = nono.getColumn(2);
+		const vector<int>& getRow(int i) const { return row[i]; }
+		const vector<vector<int>>& getColumns() const { return column; }
+		const vector<vector<int>>& getRows() const { return row; }
 	private:
 		int w = 0; //width
 		int h = 0; //height
-		char** grid = 0; //each square is marked with ' ' empty, '-' not possible, or 'X'  filled.
-		vector<int>* column = 0; //array of the column labels
-		vector<int>* row = 0; //array of the row labels
+		vector<char> cells; //row major, one allocation. each square is marked with ' ' empty, '-' not possible, or 'X'  filled.
+		vector<vector<int>> column; //the column labels
+		vector<vector<int>> row; //the row labels
+
+		enum LineState : char { LINE_DIRTY, LINE_MATCHES, LINE_MISMATCHES };
+		void touch(int x, int y); //the cell may have changed
+		void touchAll();
+		mutable vector<char> rowState; //LineState of each row, what isSolved last found
+		mutable vector<char> columnState;
+		mutable vector<int> dirtyRows; //rows in LINE_DIRTY, each once
+		mutable vector<int> dirtyColumns;
+		mutable int mismatches = 0; //lines in LINE_MISMATCHES
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include "ParallelSearch.h"
+#include "SupportCounter.h"
+#include "ThreadPool.h"
+#include <mutex>
+using namespace std;
+
+struct SharedSearch //what the tasks of one parallel search share
+{
+	ThreadPool* pool;
+	int splitDepth;
+	long long nodeLimit;
+	long long solutionLimit = 1; //stop after this many solutions, only the first is kept
+	atomic<bool> stop{ false }; //enough solutions were found or the node limit ran out
+	atomic<long long> solutions{ 0 };
+	long long probeLimit;
+	atomic<long long> nodes{ 0 };
+	atomic<long long> probes{ 0 };
+	atomic<long long> settled{ 0 };
+	atomic<size_t> trailPeak{ 0 };
+	mutex solutionLock;
+	bool solved = false;
+	vector<LineDomain> rowSolution;
+	vector<LineDomain> columnSolution;
+};
+
+static void searchTask(SharedSearch& search, vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain, int depth);
+
+static void submitTask(SharedSearch& search, vector<LineDomain> rowDomain, vector<LineDomain> columnDomain, int depth)
+{
+	SharedSearch* shared = &search;
+	search.pool->submit([shared, rowDomain = move(rowDomain), columnDomain = move(columnDomain), depth]() mutable { searchTask(*shared, rowDomain, columnDomain, depth); });
+}
+
+static void searchTask(SharedSearch& search, vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain, int depth)
+{
+	if (search.stop)
+		return;
+
+	SupportCounter counter(rowDomain, columnDomain);
+	if (!counter.propagate())
+		return;
+
+	long long found;
+	if (depth < search.splitDepth) //shallow, hand both halves of the split to the pool
+	{
+		search.nodes++;
+		bool isRow;
+		int line, cell;
+		if (chooseSplit(counter, isRow, line, cell))
+		{
+			for (bool filled : { false, true }) //submitted newest first, so the filled half runs first like macBacktrack
+			{
+				vector<LineDomain> rowHalf = rowDomain, columnHalf = columnDomain; //copies share the candidates
+				(isRow ? rowHalf : columnHalf)[line].removeCell(cell, !filled);
+				submitTask(search, move(rowHalf), move(columnHalf), depth + 1);
+			}
+			return;
+		}
+		found = 1; //every domain is singular
+	}
+	else
+	{
+		SearchStats stats;
+		stats.stop = &search.stop;
+		stats.probeLimit = search.probeLimit;
+		if (search.nodeLimit > 0) //whatever the other tasks have not used yet
+			stats.nodeLimit = max(1LL, search.nodeLimit - search.nodes.load());
+		if (search.solutionLimit == 1)
+			found = macBacktrack(counter, stats);
+		else //whatever the other tasks have not found yet
+			found = macCount(counter, max(1LL, search.solutionLimit - search.solutions.load()), stats);
+
+		search.nodes += stats.nodes;
+		search.probes += stats.probes;
+		search.settled += stats.settled;
+		size_t peak = search.trailPeak.load();
+		while (stats.trailPeak > peak && !search.trailPeak.compare_exchange_weak(peak, stats.trailPeak));
+		if (search.nodeLimit > 0 && search.nodes >= search.nodeLimit)
+			search.stop = true;
+	}
+
+	if (found > 0 && search.solutions.fetch_add(found) + found >= search.solutionLimit)
+		search.stop = true; //cancel every other worker
+	if (found > 0 && search.solutionLimit == 1)
+	{
+		lock_guard<mutex> guard(search.solutionLock);
+		if (!search.solved)
+		{
+			search.solved = true;
+			search.rowSolution = rowDomain;
+			search.columnSolution = columnDomain;
+		}
+	}
+}
+
+static void runSearch(SharedSearch& search, const vector<LineDomain>& rowDomain, const vector<LineDomain>& columnDomain, int threads, SearchStats& stats, int splitDepth)
+{
+	if (splitDepth <= 0) //about eight tasks per thread
+	{
+		splitDepth = 3;
+		while ((1 << splitDepth) < threads * 8)
+			splitDepth++;
+	}
+
+	search.splitDepth = splitDepth;
+	search.nodeLimit = stats.nodeLimit;
+	search.probeLimit = stats.probeLimit;
+	{
+		ThreadPool pool(threads);
+		search.pool = &pool;
+		submitTask(search, rowDomain, columnDomain, 0);
+		pool.wait();
+	}
+
+	stats.nodes += search.nodes;
+	stats.probes += search.probes;
+	stats.settled += search.settled;
+	stats.trailPeak = max(stats.trailPeak, search.trailPeak.load());
+}
+
+bool parallelSearch(vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain, int threads, SearchStats& stats, int splitDepth)
+{
+	SharedSearch search;
+	runSearch(search, rowDomain, columnDomain, threads, stats, splitDepth);
+	if (!search.solved)
+		return false;
+	rowDomain = search.rowSolution;
+	columnDomain = search.columnSolution;
+	return true;
+}
+
+long long parallelCount(const vector<LineDomain>& rowDomain, const vector<LineDomain>& columnDomain, int threads, long long limit, SearchStats& stats, int splitDepth)
+{
+	SharedSearch search;
+	search.solutionLimit = max(1LL, limit);
+	runSearch(search, rowDomain, columnDomain, threads, stats, splitDepth);
+	return min(search.solutions.load(), search.solutionLimit); //tasks finishing together can overshoot
+}
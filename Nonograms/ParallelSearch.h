@@ -0,0 +1,17 @@
+//maintained consistency search with its first branching levels spread over a thread pool
+#ifndef PARALLELSEARCH_H
+#define PARALLELSEARCH_H
+
+#include "Solver.h"
+#include <vector>
+using std::vector;
+
+//the domains must already be consistent. the first splitDepth levels of splits become pool tasks, deeper levels run
+//macBacktrack inside the task. every worker stops once one finds a solution, which is left in the domains.
+//splitDepth 0 picks enough levels to give each thread a few tasks to steal
+bool parallelSearch(vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain, int threads, SearchStats& stats, int splitDepth = 0);
+
+//macCount split the same way, the solutions of every task added up until they reach limit
+long long parallelCount(const vector<LineDomain>& rowDomain, const vector<LineDomain>& columnDomain, int threads, long long limit, SearchStats& stats, int splitDepth = 0);
+
+#endif
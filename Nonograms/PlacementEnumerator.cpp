@@ -0,0 +1,47 @@
+#include "PlacementEnumerator.h"
+#include <algorithm>
+using namespace std;
+
+PlacementEnumerator::PlacementEnumerator(const vector<int>& clue, int length) : clue(clue), length(length), gaps(clue.size() + 1, 0)
+{
+	int slack = length - max(0, (int)clue.size() - 1);
+	for (int block : clue)
+		slack -= block;
+	finished = slack < 0;
+	gaps.back() = max(0, slack); //the smallest composition puts all the slack after the last block
+}
+
+void PlacementEnumerator::next()
+{
+	//the next composition grows the rightmost gap that still has slack after it and moves the rest of that slack to the end
+	int last = gaps.size() - 1;
+	int tail = gaps[last]; //slack in the gaps after i
+	int i = last - 1;
+	while (i >= 0 && tail == 0)
+	{
+		tail += gaps[i];
+		gaps[i] = 0;
+		i--;
+	}
+	if (i < 0)
+	{
+		finished = true;
+		return;
+	}
+	gaps[i]++;
+	gaps[last] = tail - 1;
+}
+
+void PlacementEnumerator::writeLine(char* line) const
+{
+	int cell = 0;
+	for (int block = 0; block < clue.size(); block++)
+	{
+		int gap = gaps[block] + (block > 0); //blocks after the first need one empty cell of their own
+		fill(line + cell, line + cell + gap, ' ');
+		cell += gap;
+		fill(line + cell, line + cell + clue[block], 'X');
+		cell += clue[block];
+	}
+	fill(line + cell, line + length, ' ');
+}
@@ -0,0 +1,29 @@
+//every placement of a clue in an empty line, one at a time, without recursion or sets
+#ifndef PLACEMENTENUMERATOR_H
+#define PLACEMENTENUMERATOR_H
+
+#include <vector>
+using std::vector;
+
+//walks the extra gaps (the cells beyond the single empty cell blocks need between them) in lexicographic order, the order
+//getLineSet gives, so candidate indexes match the set based setup. the clue is kept by reference. i.e.
+//	for (PlacementEnumerator placement(clue, width); !placement.done(); placement.next())
+//		placement.writeLine(buffer);
+class PlacementEnumerator
+{
+	public:
+		PlacementEnumerator(const vector<int>& clue, int length); //at the first placement, every block as far left as it goes
+
+		bool done() const { return finished; } //no placements left, at once if the clue does not fit
+		void next();
+
+		const vector<int>& extraGaps() const { return gaps; } //blocks + 1 of them, summing to the line's slack
+		void writeLine(char* line) const; //length cells, 'X' filled and ' ' empty like decodeLineSet
+	private:
+		const vector<int>& clue;
+		int length;
+		vector<int> gaps;
+		bool finished;
+};
+
+#endif
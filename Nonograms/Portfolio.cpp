@@ -0,0 +1,212 @@
+#include "Portfolio.h"
+#include "SupportCounter.h"
+#include "LineSolver.h"
+#include "BoundedDomains.h"
+#include "Backjump.h"
+#include "SatSolver.h"
+#include "ThreadPool.h"
+#include "Arena.h"
+#include <algorithm>
+#include <mutex>
+using namespace std;
+
+vector<PortfolioConfig> defaultPortfolio(int threads)
+{
+	const long long restartNodes = 1000;
+	vector<PortfolioConfig> configs = {
+		{ ENGINE_LINES },
+		{ ENGINE_SAT },
+		{ ENGINE_MAC },
+		{ ENGINE_FORWARD, BRANCH_WEIGHTED_DEGREE, true, 1, restartNodes },
+		{ ENGINE_FORWARD, BRANCH_SMALLEST, true, 2, restartNodes },
+		{ ENGINE_BACKJUMP },
+		{ ENGINE_FORWARD, BRANCH_WEIGHTED_DEGREE, true, 3, restartNodes }
+	};
+	int count = max(2, threads);
+	for (unsigned seed = 4; configs.size() < count; seed++)
+		configs.push_back({ ENGINE_FORWARD, BRANCH_WEIGHTED_DEGREE, true, seed, restartNodes });
+	configs.resize(count);
+	return configs;
+}
+
+//no line on one side has more candidates than lineBudget
+static bool withinBudget(const vector<vector<int>>& clues, int length, double lineBudget)
+{
+	for (const vector<int>& clue : clues)
+		if (countLineOptions(clue, length) > lineBudget)
+			return false;
+	return true;
+}
+
+//the candidates of every line on one side, false once the search is stopped
+static bool lineDomains(const vector<vector<int>>& clues, int length, vector<LineDomain>& domains, const SearchStats& stats)
+{
+	vector<char> unknown(length, ' ');
+	domains.reserve(clues.size());
+	for (const vector<int>& clue : clues)
+	{
+		if (stats.limitReached())
+			return false;
+		domains.push_back(LineDomain(length));
+		addPlacements(clue, unknown, domains.back());
+	}
+	return true;
+}
+
+//candidate domains for the domain engines, false when a line is over the budget or another configuration answered while
+//they were built, which can take longer than solving
+static bool domainsFor(const Nonogram& n, double lineBudget, vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain, const SearchStats& stats)
+{
+	int width = n.getWidth(), height = n.getHeight();
+	return withinBudget(n.getRows(), width, lineBudget) && withinBudget(n.getColumns(), height, lineBudget)
+		&& lineDomains(n.getRows(), width, rowDomain, stats) && lineDomains(n.getColumns(), height, columnDomain, stats);
+}
+
+//a search that failed without reaching its limit or being stopped went through every possibility
+static PortfolioResult failed(const SearchStats& stats)
+{
+	return stats.limitReached() ? PORTFOLIO_GAVE_UP : PORTFOLIO_UNSOLVABLE;
+}
+
+//backtrack run after run, each limited to restartNodes times the next luby number and shuffled by the next seed. failure
+//weights carry over, so later runs start from the lines that failed before
+static bool restartingBacktrack(const PortfolioConfig& config, vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain, SearchStats& stats)
+{
+	vector<double> lineWeights;
+	double weightIncrement = 1;
+	for (int run = 0; ; run++)
+	{
+		mt19937 random(config.seed + run);
+		SearchStats runStats;
+		runStats.stop = stats.stop;
+		runStats.branching = config.branching;
+		runStats.supportOrder = config.supportOrder;
+		runStats.random = config.seed != 0 ? &random : nullptr;
+		runStats.lineWeights.swap(lineWeights);
+		runStats.weightIncrement = weightIncrement;
+		long long budget = config.restartNodes > 0 ? (long long)(config.restartNodes * luby(run)) : 0;
+		if (stats.nodeLimit > 0)
+			budget = budget > 0 ? min(budget, stats.nodeLimit - stats.nodes) : stats.nodeLimit - stats.nodes;
+		runStats.nodeLimit = budget;
+
+		vector<LineDomain> rows = rowDomain, columns = columnDomain;
+		vector<bool> rowAssign(rows.size(), false), columnAssign(columns.size(), false);
+		vector<trailType> trail;
+		bool found = backtrack(rows, columns, rowAssign, columnAssign, trail, runStats);
+		stats.nodes += runStats.nodes;
+		stats.trailPeak = max(stats.trailPeak, runStats.trailPeak);
+		if (found)
+		{
+			rowDomain.swap(rows);
+			columnDomain.swap(columns);
+			return true;
+		}
+		if (config.restartNodes == 0 || !runStats.limitReached() || stats.limitReached()) //searched through, or out of nodes
+			return false;
+		lineWeights.swap(runStats.lineWeights);
+		weightIncrement = runStats.weightIncrement;
+	}
+}
+
+//one configuration on its own copy of the puzzle, the solution is left in attempt
+static PortfolioResult runConfig(const PortfolioConfig& config, Nonogram& attempt, SearchStats& stats, double lineBudget)
+{
+	int width = attempt.getWidth(), height = attempt.getHeight();
+	if (config.engine == ENGINE_LINES)
+	{
+		stats.probeLimit = defaultProbeLimit;
+		vector<vector<char>> grid(width, vector<char>(height, ' '));
+		if (!lineSearch(attempt, grid, stats))
+			return failed(stats);
+		for (int x = 0; x < width; x++)
+			for (int y = 0; y < height; y++)
+				attempt[x][y] = grid[x][y] == 'X' ? 'X' : ' ';
+		return PORTFOLIO_SOLVED;
+	}
+	if (config.engine == ENGINE_SAT)
+	{
+		SatSolver solver(encodeNonogram(attempt));
+		if (stats.limitReached()) //the encoding does not look at stop, another configuration may have answered meanwhile
+			return PORTFOLIO_GAVE_UP;
+		SatResult result = solver.solve(stats);
+		if (result != SAT_SATISFIABLE)
+			return result == SAT_UNSATISFIABLE ? PORTFOLIO_UNSOLVABLE : PORTFOLIO_GAVE_UP;
+		for (int x = 0; x < width; x++)
+			for (int y = 0; y < height; y++)
+				attempt[x][y] = solver.value(y * width + x + 1) ? 'X' : ' ';
+		return PORTFOLIO_SOLVED;
+	}
+
+	vector<LineDomain> rowDomain, columnDomain;
+	if (!domainsFor(attempt, lineBudget, rowDomain, columnDomain, stats))
+		return PORTFOLIO_GAVE_UP; //left out or stopped, which says nothing about the puzzle
+	if (!supportConsistency(rowDomain, columnDomain))
+		return PORTFOLIO_UNSOLVABLE;
+	if (stats.limitReached())
+		return PORTFOLIO_GAVE_UP;
+	bool found;
+	if (config.engine == ENGINE_MAC)
+	{
+		stats.probeLimit = defaultProbeLimit;
+		SupportCounter counter(rowDomain, columnDomain);
+		found = counter.propagate() && macBacktrack(counter, stats);
+	}
+	else if (config.engine == ENGINE_BACKJUMP)
+		found = backjump(rowDomain, columnDomain, stats);
+	else
+		found = restartingBacktrack(config, rowDomain, columnDomain, stats);
+	if (!found)
+		return failed(stats);
+	for (int x = 0; x < width; x++)
+	{
+		const LineDomain& column = columnDomain[x];
+		for (int y = 0; y < height; y++)
+			attempt[x][y] = column.getCell(column.first(), y);
+	}
+	return PORTFOLIO_SOLVED;
+}
+
+PortfolioResult solvePortfolio(Nonogram& n, const vector<PortfolioConfig>& configs, PortfolioReport& report, long long nodeLimit, double lineBudget)
+{
+	atomic<bool> stop{ false }; //set by the winner
+	atomic<long long> nodes{ 0 };
+	mutex lock;
+	int winner = -1;
+	PortfolioResult answer = PORTFOLIO_GAVE_UP;
+	Nonogram solution = n;
+	{
+		ThreadPool pool(configs.size()); //a worker each, so every configuration runs from the start
+		for (int i = 0; i < configs.size(); i++)
+			pool.submit([&, i]()
+			{
+				Arena arena; //every configuration scratches in its own, like separate solves
+				ArenaScope scope(Arena::enabled() ? &arena : nullptr);
+				Nonogram attempt = n;
+				SearchStats stats;
+				stats.nodeLimit = nodeLimit;
+				stats.stop = &stop;
+				PortfolioResult result = runConfig(configs[i], attempt, stats, lineBudget);
+				if (result == PORTFOLIO_SOLVED && !attempt.isSolved())
+					result = PORTFOLIO_GAVE_UP;
+				nodes += stats.nodes;
+				if (result == PORTFOLIO_GAVE_UP)
+					return;
+				lock_guard<mutex> guard(lock);
+				if (winner == -1)
+				{
+					winner = i;
+					answer = result;
+					if (result == PORTFOLIO_SOLVED)
+						solution = move(attempt);
+					stop = true; //cancel every other configuration, the answer is known
+				}
+			});
+		pool.wait();
+	}
+
+	report.winner = winner;
+	report.nodes += nodes;
+	if (answer == PORTFOLIO_SOLVED)
+		n = move(solution);
+	return answer;
+}
@@ -0,0 +1,51 @@
+//differently configured solvers racing on their own threads for one puzzle, the first answer cancels the rest
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+#include "Nonogram.h"
+#include "Solver.h"
+#include <vector>
+using std::vector;
+
+enum PortfolioEngine
+{
+	ENGINE_LINES, //lineSearch with probing
+	ENGINE_MAC, //macBacktrack over support counting with probing
+	ENGINE_FORWARD, //backtrack with the configuration's branching, restarted with growing node limits
+	ENGINE_BACKJUMP, //backjump with learned nogoods
+	ENGINE_SAT //SatSolver on encodeNonogram, like solveSat
+};
+
+struct PortfolioConfig
+{
+	PortfolioEngine engine;
+	Branching branching = BRANCH_SMALLEST; //the rest only matter for ENGINE_FORWARD
+	bool supportOrder = false;
+	unsigned seed = 0; //0 keeps the candidate order, otherwise candidates are shuffled and every restart takes the next seed
+	long long restartNodes = 0; //nodes of the first run, later runs follow the luby sequence. 0 never restarts
+};
+
+//the first threads configurations of a fixed list, at least two: line solving, sat, maintained consistency, forward
+//checking by weighted degree and by smallest domain, backjumping, then weighted degree again. every forward checking
+//configuration has its own seed, past the list only the seeds differ
+vector<PortfolioConfig> defaultPortfolio(int threads);
+
+enum PortfolioResult
+{
+	PORTFOLIO_SOLVED,
+	PORTFOLIO_UNSOLVABLE, //a configuration searched through every possibility, or the labels contradict
+	PORTFOLIO_GAVE_UP //every configuration reached the node limit or was left out for lines over the budget
+};
+
+struct PortfolioReport
+{
+	int winner = -1; //the configuration that answered, -1 if none did
+	long long nodes = 0; //of every configuration, the cancelled ones included
+};
+
+//each configuration gets a thread and solves the labels of n. the first definitive answer, a solution written into n or a
+//proof there is none, stops every other search at its next node. domains over lineBudget candidates leave the domain
+//engines out. a nodeLimit above 0 bounds each configuration
+PortfolioResult solvePortfolio(Nonogram& n, const vector<PortfolioConfig>& configs, PortfolioReport& report, long long nodeLimit = 0, double lineBudget = defaultLineBudget);
+
+#endif
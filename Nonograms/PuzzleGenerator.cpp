@@ -0,0 +1,132 @@
+#include "PuzzleGenerator.h"
+#include "LineDomain.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <random>
+using namespace std;
+
+static uint64_t splitMix(uint64_t& x)
+{
+	uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+static uint64_t rotateLeft(uint64_t x, int k)
+{
+	return (x << k) | (x >> (64 - k));
+}
+
+PuzzleGenerator::PuzzleGenerator(uint64_t seed)
+{
+	for (uint64_t& word : state)
+		word = splitMix(seed);
+}
+
+uint64_t PuzzleGenerator::randomSeed()
+{
+	static atomic<uint64_t> calls(0); //two seeds taken in the same clock tick still differ
+	uint64_t seed = random_device()() ^ (uint64_t)chrono::steady_clock::now().time_since_epoch().count();
+	seed += calls++ * 0x9E3779B97F4A7C15ULL;
+	return splitMix(seed);
+}
+
+uint64_t PuzzleGenerator::next()
+{
+	uint64_t result = rotateLeft(state[1] * 5, 7) * 9;
+	uint64_t t = state[1] << 17;
+	state[2] ^= state[0];
+	state[3] ^= state[1];
+	state[1] ^= state[2];
+	state[0] ^= state[3];
+	state[2] ^= t;
+	state[3] = rotateLeft(state[3], 45);
+	return result;
+}
+
+uint64_t PuzzleGenerator::nextCells(int density)
+{
+	if (density <= 0)
+		return 0;
+	if (density >= 256)
+		return ~0ULL;
+
+	//read density as the binary fraction 0.b7b6...b0, from the lowest set bit up a 1 ors in a fresh word and a 0
+	//ands one in, so every bit of the result is set with chance density / 256. 1/2 takes one word, 3/4 two
+	uint64_t cells = 0;
+	for (int bit = countTrailingZeros(density); bit < 8; bit++)
+		cells = (density >> bit & 1) ? (next() | cells) : (next() & cells);
+	return cells;
+}
+
+//first cell at or after from that is filled (or empty), width if there is none
+static int findCell(const uint64_t* row, int words, int width, int from, bool filled)
+{
+	for (int k = from / 64; k < words; k++)
+	{
+		uint64_t word = filled ? row[k] : ~row[k];
+		if (k == from / 64)
+			word &= ~0ULL << (from % 64);
+		if (word != 0)
+			return min(width, k * 64 + countTrailingZeros(word));
+	}
+	return width;
+}
+
+//whole runs at a time from the bits
+static void labelRuns(const uint64_t* line, int words, int length, vector<int>& labels)
+{
+	labels.clear();
+	for (int start = findCell(line, words, length, 0, true); start < length; )
+	{
+		int end = findCell(line, words, length, start, false);
+		labels.push_back(end - start);
+		start = end < length ? findCell(line, words, length, end, true) : length;
+	}
+}
+
+void PuzzleGenerator::generate(int width, int height, double density, vector<uint64_t>& cells, vector<vector<int>>& rows, vector<vector<int>>& columns)
+{
+	if (width == 0 || height == 0) //no cells to fill, every line of an empty grid has no labels
+	{
+		cells.clear();
+		rows.assign(height, vector<int>());
+		columns.assign(width, vector<int>());
+		return;
+	}
+	int words = (width + 63) / 64;
+	int scaled = (int)lround(density * 256);
+	uint64_t lastMask = width % 64 == 0 ? ~0ULL : (1ULL << (width % 64)) - 1; //cells past the width stay empty
+	cells.resize((size_t)words * height);
+	for (int y = 0; y < height; y++)
+	{
+		for (int k = 0; k < words; k++)
+			cells[(size_t)y * words + k] = nextCells(scaled);
+		cells[(size_t)y * words + words - 1] &= lastMask;
+	}
+
+	rows.resize(height);
+	for (int y = 0; y < height; y++)
+		labelRuns(&cells[(size_t)y * words], words, width, rows[y]);
+
+	int columnWords = (height + 63) / 64; //the cells transposed, one set bit at a time, so columns are labeled the same way
+	columnCells.assign((size_t)columnWords * width, 0);
+	for (int y = 0; y < height; y++)
+		for (int k = 0; k < words; k++)
+			for (uint64_t word = cells[(size_t)y * words + k]; word != 0; word &= word - 1)
+				columnCells[(size_t)(k * 64 + countTrailingZeros(word)) * columnWords + y / 64] |= 1ULL << (y % 64);
+
+	columns.resize(width);
+	for (int x = 0; x < width; x++)
+		labelRuns(&columnCells[(size_t)x * columnWords], columnWords, height, columns[x]);
+}
+
+Nonogram PuzzleGenerator::puzzle(int width, int height, double density)
+{
+	vector<uint64_t> cells;
+	vector<vector<int>> rows, columns;
+	generate(width, height, density, cells, rows, columns);
+	return Nonogram(move(rows), move(columns));
+}
@@ -0,0 +1,30 @@
+//seeded random puzzles, the same seed and density give the same puzzle on every platform
+#ifndef PUZZLEGENERATOR_H
+#define PUZZLEGENERATOR_H
+
+#include "Nonogram.h"
+#include <cstdint>
+#include <vector>
+using std::uint64_t;
+using std::vector;
+
+class PuzzleGenerator
+{
+	public:
+		explicit PuzzleGenerator(uint64_t seed); //splitmix64 spreads the seed over the whole state
+		static uint64_t randomSeed(); //different on every call, for puzzles that do not need to be reproduced
+
+		uint64_t next(); //xoshiro256**
+		uint64_t nextCells(int density); //64 bits each set with chance density / 256, one draw per bit of density used
+
+		//density is the chance a cell is filled, rounded to a multiple of 1/256. the grid is left blank
+		Nonogram puzzle(int width, int height, double density = 0.5);
+		//the same puzzle without building a Nonogram, reusing the storage of the vectors, for load testing.
+		//cells holds (width + 63) / 64 words per row, bit x % 64 of word x / 64 is cell x
+		void generate(int width, int height, double density, vector<uint64_t>& cells, vector<vector<int>>& rows, vector<vector<int>>& columns);
+	private:
+		uint64_t state[4];
+		vector<uint64_t> columnCells; //generate's transposed cells, kept to reuse the storage
+};
+
+#endif
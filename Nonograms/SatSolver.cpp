@@ -0,0 +1,512 @@
+#include "SatSolver.h"
+#include <algorithm>
+#include <cmath>
+using namespace std;
+
+//the run of the clue's automaton over a line of cells: state q has read the first q cells of the shortest line with the
+//clue, where the blocks are one empty cell apart. empty cells loop before the first block, between blocks and after the last
+static void encodeLine(Cnf& cnf, const vector<int>& cells, const vector<int>& clue)
+{
+	vector<bool> pattern;
+	for (int block : clue)
+		if (block > 0)
+		{
+			if (!pattern.empty())
+				pattern.push_back(false);
+			pattern.insert(pattern.end(), block, true);
+		}
+	int length = cells.size();
+	int patternLength = pattern.size();
+	if (patternLength > length) //the clue does not fit
+	{
+		cnf.addClause({});
+		return;
+	}
+
+	//after i cells only the states that read at most i cells and can still finish in the rest of the line are possible
+	auto lowest = [&](int i) { return max(0, patternLength - (length - i)); };
+	auto highest = [&](int i) { return min(i, patternLength); };
+	vector<vector<int>> states(length + 1);
+	for (int i = 0; i <= length; i++)
+		for (int q = lowest(i); q <= highest(i); q++)
+			states[i].push_back(cnf.addVariable());
+	auto state = [&](int i, int q) { return q < lowest(i) || q > highest(i) ? 0 : states[i][q - lowest(i)]; };
+	auto transition = [&](int q, bool filled) //the next state, -1 if the cell does not fit the clue
+	{
+		if (q < patternLength && pattern[q] == filled)
+			return q + 1;
+		if (!filled && (q == 0 || q == patternLength || !pattern[q - 1]))
+			return q;
+		return -1;
+	};
+
+	cnf.addClause({ state(0, 0) });
+	cnf.addClause({ state(length, patternLength) });
+	for (int i = 0; i < length; i++)
+	{
+		for (int q = lowest(i); q <= highest(i); q++)
+			for (bool filled : { true, false })
+			{
+				int cell = filled ? cells[i] : -cells[i];
+				int next = transition(q, filled);
+				int target = next == -1 ? 0 : state(i + 1, next);
+				if (target != 0)
+					cnf.addClause({ -state(i, q), -cell, target });
+				else
+					cnf.addClause({ -state(i, q), -cell });
+			}
+
+		for (int next = lowest(i + 1); next <= highest(i + 1); next++)
+		{
+			ArenaVector<int> support = { -state(i + 1, next) };
+			bool byFilled = false, byEmpty = false;
+			for (int q = lowest(i); q <= highest(i); q++)
+				for (bool filled : { true, false })
+					if (transition(q, filled) == next)
+					{
+						support.push_back(state(i, q));
+						(filled ? byFilled : byEmpty) = true;
+					}
+			cnf.addClause(move(support));
+			if (byFilled != byEmpty) //only one kind of cell leads to the state
+				cnf.addClause({ -state(i + 1, next), byFilled ? cells[i] : -cells[i] });
+		}
+	}
+}
+
+Cnf encodeNonogram(const Nonogram& n)
+{
+	Cnf cnf;
+	int width = n.getWidth(), height = n.getHeight();
+	cnf.variables = width * height;
+	cnf.decisionVariables = width * height; //the cells decide every automaton state
+	vector<int> cells;
+	for (int y = 0; y < height; y++)
+	{
+		cells.clear();
+		for (int x = 0; x < width; x++)
+			cells.push_back(y * width + x + 1);
+		encodeLine(cnf, cells, n.getRow(y));
+	}
+	for (int x = 0; x < width; x++)
+	{
+		cells.clear();
+		for (int y = 0; y < height; y++)
+			cells.push_back(y * width + x + 1);
+		encodeLine(cnf, cells, n.getColumn(x));
+	}
+	return cnf;
+}
+
+void writeDimacs(ostream& out, const Cnf& cnf)
+{
+	out << "p cnf " << cnf.variables << ' ' << cnf.clauses.size() << '\n';
+	for (const ArenaVector<int>& clause : cnf.clauses)
+	{
+		for (int literal : clause)
+			out << literal << ' ';
+		out << "0\n";
+	}
+}
+
+double luby(int restart)
+{
+	int size = 1, power = 0;
+	while (size < restart + 1)
+	{
+		power++;
+		size = 2 * size + 1;
+	}
+	while (size - 1 != restart)
+	{
+		size = (size - 1) >> 1;
+		power--;
+		restart %= size;
+	}
+	return pow(2.0, power);
+}
+
+SatSolver::SatSolver(const Cnf& cnf) : variables(cnf.variables)
+{
+	decisionVariables = cnf.decisionVariables > 0 ? cnf.decisionVariables : variables;
+	watches.resize(2 * (size_t)variables);
+	assignment.assign(variables, 2);
+	phase.assign(variables, 0); //empty cells first, most puzzles are about half empty and the state variables follow the cells
+	level.assign(variables, 0);
+	reason.assign(variables, -1);
+	activity.assign(variables, 0);
+	heapIndex.assign(variables, -1);
+	seen.assign(variables, 0);
+	for (int v = 0; v < decisionVariables; v++)
+		heapInsert(v);
+	for (const ArenaVector<int>& clause : cnf.clauses)
+	{
+		ArenaVector<int> literals;
+		literals.reserve(clause.size());
+		for (int dimacs : clause)
+			literals.push_back(literal(dimacs));
+		addInput(move(literals));
+	}
+}
+
+void SatSolver::addInput(ArenaVector<int> literals)
+{
+	if (inconsistent)
+		return;
+	sort(literals.begin(), literals.end());
+	literals.erase(unique(literals.begin(), literals.end()), literals.end());
+	for (size_t i = 1; i < literals.size(); i++)
+		if (literals[i] == (literals[i - 1] ^ 1)) //a variable and its negation, always true
+			return;
+
+	if (literals.empty())
+		inconsistent = true;
+	else if (literals.size() == 1)
+	{
+		if (valueOf(literals[0]) == 0)
+			inconsistent = true;
+		else if (valueOf(literals[0]) == 2)
+			assign(literals[0], -1);
+	}
+	else
+	{
+		clauses.push_back(Clause{ move(literals), false, 0 });
+		watch(clauses.size() - 1);
+	}
+}
+
+int SatSolver::addLearned(const vector<int>& literals, int glue)
+{
+	clauses.push_back(Clause{ ArenaVector<int>(literals.begin(), literals.end(), ArenaAllocator<int>(nullptr)), true, glue });
+	watch(clauses.size() - 1);
+	learnedClauses++;
+	counts.learned++;
+	return clauses.size() - 1;
+}
+
+void SatSolver::watch(int clause)
+{
+	const ArenaVector<int>& literals = clauses[clause].literals;
+	watches[literals[0] ^ 1].push_back(Watcher{ clause, literals[1] });
+	watches[literals[1] ^ 1].push_back(Watcher{ clause, literals[0] });
+}
+
+void SatSolver::assign(int literal, int because)
+{
+	int variable = literal >> 1;
+	assignment[variable] = !(literal & 1);
+	level[variable] = trailLimits.size();
+	reason[variable] = because;
+	trail.push_back(literal);
+}
+
+int SatSolver::propagate()
+{
+	while (propagated < trail.size())
+	{
+		int falsified = trail[propagated++] ^ 1;
+		ArenaVector<Watcher>& list = watches[falsified ^ 1];
+		size_t i = 0, j = 0;
+		while (i < list.size())
+		{
+			Watcher watcher = list[i++];
+			if (valueOf(watcher.blocker) == 1)
+			{
+				list[j++] = watcher;
+				continue;
+			}
+			ArenaVector<int>& literals = clauses[watcher.clause].literals;
+			if (literals[0] == falsified) //the falsified watch goes second
+				swap(literals[0], literals[1]);
+			int first = literals[0];
+			if (first != watcher.blocker && valueOf(first) == 1)
+			{
+				list[j++] = Watcher{ watcher.clause, first };
+				continue;
+			}
+
+			bool moved = false; //look for a literal that is not false to watch instead
+			for (size_t k = 2; k < literals.size() && !moved; k++)
+				if (valueOf(literals[k]) != 0)
+				{
+					literals[1] = literals[k];
+					literals[k] = falsified;
+					watches[literals[1] ^ 1].push_back(Watcher{ watcher.clause, first });
+					moved = true;
+				}
+			if (moved)
+				continue;
+
+			list[j++] = Watcher{ watcher.clause, first };
+			if (valueOf(first) == 0) //every literal false
+			{
+				while (i < list.size())
+					list[j++] = list[i++];
+				list.resize(j);
+				propagated = trail.size();
+				return watcher.clause;
+			}
+			assign(first, watcher.clause);
+			counts.propagations++;
+		}
+		list.resize(j);
+	}
+	return -1;
+}
+
+void SatSolver::analyze(int conflict, vector<int>& learned, int& backLevel, int& glue)
+{
+	//walk the trail back from the conflict until one literal of the current level is left, the first unique implication point
+	learned.assign(1, -1);
+	int currentLevel = trailLimits.size();
+	int pending = 0; //literals of the current level still to resolve
+	int resolved = -1;
+	int index = trail.size() - 1;
+	int clause = conflict;
+	do
+	{
+		const ArenaVector<int>& literals = clauses[clause].literals;
+		for (size_t j = resolved == -1 ? 0 : 1; j < literals.size(); j++) //the first literal of a reason is the one it implied
+		{
+			int variable = literals[j] >> 1;
+			if (seen[variable] || level[variable] == 0)
+				continue;
+			bump(variable);
+			seen[variable] = 1;
+			if (level[variable] >= currentLevel)
+				pending++;
+			else
+				learned.push_back(literals[j]);
+		}
+		while (!seen[trail[index] >> 1])
+			index--;
+		resolved = trail[index--];
+		clause = reason[resolved >> 1];
+		seen[resolved >> 1] = 0;
+		pending--;
+	} while (pending > 0);
+	learned[0] = resolved ^ 1;
+
+	vector<int> marked(learned.begin() + 1, learned.end()); //seen until minimization is done
+	size_t kept = 1;
+	for (size_t i = 1; i < learned.size(); i++)
+		if (!redundant(learned[i]))
+			learned[kept++] = learned[i];
+	learned.resize(kept);
+	for (int literal : marked)
+		seen[literal >> 1] = 0;
+
+	backLevel = 0;
+	vector<int> levels;
+	for (size_t i = 1; i < learned.size(); i++)
+	{
+		int literalLevel = level[learned[i] >> 1];
+		levels.push_back(literalLevel);
+		if (literalLevel > backLevel)
+		{
+			backLevel = literalLevel;
+			swap(learned[1], learned[i]); //watched, so it is the literal that turns false last when jumping back
+		}
+	}
+	levels.push_back(currentLevel);
+	sort(levels.begin(), levels.end());
+	glue = unique(levels.begin(), levels.end()) - levels.begin();
+}
+
+bool SatSolver::redundant(int literal) const
+{
+	int because = reason[literal >> 1];
+	if (because == -1)
+		return false;
+	const ArenaVector<int>& literals = clauses[because].literals;
+	for (size_t j = 1; j < literals.size(); j++)
+		if (!seen[literals[j] >> 1] && level[literals[j] >> 1] > 0)
+			return false;
+	return true;
+}
+
+void SatSolver::cancelUntil(int targetLevel)
+{
+	if (trailLimits.size() <= targetLevel)
+		return;
+	for (int i = trail.size() - 1; i >= trailLimits[targetLevel]; i--)
+	{
+		int variable = trail[i] >> 1;
+		phase[variable] = assignment[variable];
+		assignment[variable] = 2;
+		if (heapIndex[variable] == -1 && variable < decisionVariables)
+			heapInsert(variable);
+	}
+	trail.resize(trailLimits[targetLevel]);
+	trailLimits.resize(targetLevel);
+	propagated = trail.size();
+}
+
+int SatSolver::pickBranch()
+{
+	while (!heap.empty())
+	{
+		int variable = heapPop();
+		if (assignment[variable] == 2)
+			return 2 * variable + (phase[variable] ? 0 : 1);
+	}
+	return -1;
+}
+
+void SatSolver::reduceLearned()
+{
+	//the learned clauses of high glue are the least likely to help again, the worse half of them goes
+	vector<int> learned;
+	for (int i = 0; i < clauses.size(); i++)
+		if (clauses[i].learned && clauses[i].glue > 2)
+			learned.push_back(i);
+	stable_sort(learned.begin(), learned.end(), [&](int a, int b) { return clauses[a].glue > clauses[b].glue; });
+	vector<char> drop(clauses.size(), 0);
+	for (size_t i = 0; i < learned.size() / 2; i++)
+		drop[learned[i]] = 1;
+
+	size_t kept = 0;
+	for (size_t i = 0; i < clauses.size(); i++)
+		if (!drop[i])
+			clauses[kept++] = move(clauses[i]);
+	counts.deleted += clauses.size() - kept;
+	learnedClauses -= clauses.size() - kept;
+	clauses.resize(kept);
+
+	for (int literal : trail) //level 0 literals are never resolved, they need no reasons
+		reason[literal >> 1] = -1;
+	for (ArenaVector<Watcher>& list : watches)
+		list.clear();
+	for (int i = 0; i < clauses.size(); i++)
+		watch(i);
+}
+
+void SatSolver::bump(int variable)
+{
+	activity[variable] += increment;
+	if (activity[variable] > 1e100)
+	{
+		for (double& value : activity)
+			value *= 1e-100;
+		increment *= 1e-100;
+	}
+	if (heapIndex[variable] != -1)
+		heapUp(heapIndex[variable]);
+}
+
+SatResult SatSolver::solve(SearchStats& stats)
+{
+	if (inconsistent || propagate() != -1)
+		return SAT_UNSATISFIABLE;
+
+	size_t learnedLimit = max((size_t)2000, clauses.size() / 3);
+	vector<int> learned;
+	for (int restart = 0; ; restart++)
+	{
+		long long conflictBudget = (long long)(100 * luby(restart));
+		for (long long conflicts = 0; ; )
+		{
+			int conflict = propagate();
+			if (conflict != -1)
+			{
+				counts.conflicts++;
+				conflicts++;
+				if (trailLimits.empty())
+					return SAT_UNSATISFIABLE;
+				int backLevel, glue;
+				analyze(conflict, learned, backLevel, glue);
+				cancelUntil(backLevel);
+				if (learned.size() == 1)
+					assign(learned[0], -1);
+				else
+					assign(learned[0], addLearned(learned, glue));
+				increment /= 0.95; //older bumps count for less
+				continue;
+			}
+
+			if (conflicts >= conflictBudget)
+			{
+				cancelUntil(0);
+				counts.restarts++;
+				if (learnedClauses > learnedLimit)
+				{
+					reduceLearned();
+					learnedLimit += learnedLimit / 10;
+				}
+				break;
+			}
+			int decision = pickBranch();
+			if (decision == -1) //every decision variable assigned without a conflict, the rest can be false
+				return SAT_SATISFIABLE;
+			if (stats.limitReached())
+				return SAT_UNKNOWN;
+			stats.nodes++;
+			counts.decisions++;
+			trailLimits.push_back(trail.size());
+			assign(decision, -1);
+		}
+	}
+}
+
+void SatSolver::heapInsert(int variable)
+{
+	heapIndex[variable] = heap.size();
+	heap.push_back(variable);
+	heapUp(heap.size() - 1);
+}
+
+int SatSolver::heapPop()
+{
+	int top = heap[0];
+	heapIndex[top] = -1;
+	heap[0] = heap.back();
+	heap.pop_back();
+	if (!heap.empty())
+	{
+		heapIndex[heap[0]] = 0;
+		heapDown(0);
+	}
+	return top;
+}
+
+void SatSolver::heapUp(int position)
+{
+	int variable = heap[position];
+	while (position > 0 && activity[heap[(position - 1) / 2]] < activity[variable])
+	{
+		heap[position] = heap[(position - 1) / 2];
+		heapIndex[heap[position]] = position;
+		position = (position - 1) / 2;
+	}
+	heap[position] = variable;
+	heapIndex[variable] = position;
+}
+
+void SatSolver::heapDown(int position)
+{
+	int variable = heap[position];
+	while (2 * position + 1 < heap.size())
+	{
+		int child = 2 * position + 1;
+		if (child + 1 < heap.size() && activity[heap[child + 1]] > activity[heap[child]])
+			child++;
+		if (activity[heap[child]] <= activity[variable])
+			break;
+		heap[position] = heap[child];
+		heapIndex[heap[position]] = position;
+		position = child;
+	}
+	heap[position] = variable;
+	heapIndex[variable] = position;
+}
+
+bool solveSat(Nonogram& n, SearchStats& stats)
+{
+	SatSolver solver(encodeNonogram(n));
+	if (solver.solve(stats) != SAT_SATISFIABLE)
+		return false;
+	for (int x = 0; x < n.getWidth(); x++)
+		for (int y = 0; y < n.getHeight(); y++)
+			n[x][y] = solver.value(y * n.getWidth() + x + 1) ? 'X' : ' ';
+	return true;
+}
@@ -0,0 +1,111 @@
+//the nonogram as boolean satisfiability: cells are variables, clues are clauses, solved by conflict driven clause learning
+#ifndef SATSOLVER_H
+#define SATSOLVER_H
+
+#include "Nonogram.h"
+#include "Solver.h"
+#include "Arena.h"
+#include <initializer_list>
+#include <ostream>
+#include <vector>
+using std::ostream;
+using std::vector;
+
+struct Cnf //clauses over variables 1..variables, -v is v negated like in DIMACS
+{
+	int variables = 0;
+	int decisionVariables = 0; //variables 1..this are enough to branch on, the rest follow. 0 branches on all of them
+	vector<ArenaVector<int>> clauses; //from the arena of the solve encoding them
+
+	int addVariable() { return ++variables; }
+	void addClause(std::initializer_list<int> clause) { clauses.emplace_back(clause); }
+	void addClause(ArenaVector<int> clause) { clauses.push_back(std::move(clause)); }
+};
+
+//cell (x, y) is variable y * width + x + 1, true when filled. each line runs the automaton of its clue, with a variable
+//per state it can be in after each cell: a state and a cell imply the next state, the cells no state accepts are refused,
+//and a state implies one of the states leading to it so propagation works both ways along the line
+Cnf encodeNonogram(const Nonogram& n);
+void writeDimacs(ostream& out, const Cnf& cnf); //the DIMACS cnf format other SAT solvers read
+
+enum SatResult
+{
+	SAT_SATISFIABLE,
+	SAT_UNSATISFIABLE,
+	SAT_UNKNOWN //the limit was reached first
+};
+
+struct SatStats
+{
+	long long decisions = 0;
+	long long conflicts = 0;
+	long long propagations = 0; //literals assigned by unit propagation
+	long long restarts = 0;
+	long long learned = 0;
+	long long deleted = 0; //learned clauses dropped again
+};
+
+//two watched literals, the first unique implication point learned on every conflict, variable activity for decisions with
+//saved phases, luby restarts and learned clauses halved by glue at restarts once there are too many
+class SatSolver
+{
+	public:
+		explicit SatSolver(const Cnf& cnf);
+		SatResult solve(SearchStats& stats); //decisions count as nodes, gives up once stats.limitReached()
+		bool value(int variable) const { return assignment[variable - 1] == 1; } //after SAT_SATISFIABLE
+		const SatStats& getStats() const { return counts; }
+	private:
+		struct Clause
+		{
+			ArenaVector<int> literals; //the first two are watched. input clauses come from the arena, learned ones from the heap
+			bool learned;
+			int glue; //decision levels among the literals when learned
+		};
+		struct Watcher
+		{
+			int clause;
+			int blocker; //a literal of the clause, when true the clause needs no look
+		};
+
+		static int literal(int dimacs) { return dimacs > 0 ? 2 * (dimacs - 1) : 2 * (-dimacs - 1) + 1; }
+		int valueOf(int literal) const { return assignment[literal >> 1] == 2 ? 2 : assignment[literal >> 1] ^ (literal & 1); } //1 true, 0 false, 2 unassigned
+
+		void addInput(ArenaVector<int> literals); //duplicates and tautologies dropped, units assigned at level 0
+		int addLearned(const vector<int>& literals, int glue); //asserting literal first, then one of the highest level
+		void watch(int clause);
+		void assign(int literal, int reason);
+		int propagate(); //the conflicting clause, -1 if none
+		void analyze(int conflict, vector<int>& learned, int& backLevel, int& glue);
+		bool redundant(int literal) const; //implied by the other literals of the learned clause
+		void cancelUntil(int level);
+		int pickBranch();
+		void reduceLearned(); //at level 0 only, reasons are dropped
+		void bump(int variable);
+
+		void heapInsert(int variable);
+		int heapPop();
+		void heapUp(int position);
+		void heapDown(int position);
+
+		int variables;
+		int decisionVariables; //the heap holds only these
+		bool inconsistent = false; //an empty clause or conflicting units
+		vector<Clause> clauses;
+		vector<ArenaVector<Watcher>> watches; //per literal, the clauses watching its negation, from the arena like input clauses
+		vector<char> assignment; //per variable, 1 true, 0 false, 2 unassigned
+		vector<char> phase; //the value each variable last had
+		vector<int> level, reason; //per assigned variable, reason -1 for decisions
+		vector<int> trail, trailLimits; //assigned literals, where each decision level starts
+		size_t propagated = 0; //trail literals whose watches were visited
+		vector<double> activity;
+		double increment = 1;
+		vector<int> heap, heapIndex; //variables by activity, heapIndex -1 when out of the heap
+		vector<char> seen;
+		int learnedClauses = 0;
+		SatStats counts;
+};
+
+double luby(int restart); //1 1 2 1 1 2 4 1 1 2 ..., the length of each restart in units, counting from 0
+bool solveSat(Nonogram& n, SearchStats& stats); //encodeNonogram through SatSolver, writes the solution into n
+
+#endif
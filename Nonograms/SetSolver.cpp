@@ -0,0 +1,217 @@
+#include "SetSolver.h"
+#include <queue>
+#include <climits>
+using namespace std;
+
+namespace setSolver
+{
+long long backtrackNodes = 0;
+
+vector<set<vector<char>>> getRowOptions(const Nonogram& n)
+{
+	vector<set<vector<char>>> options(n.getHeight()); //size
+	for (int row = 0; row < n.getHeight(); row++)
+	{
+		set< vector<char> > rowOptions;
+		int width = getWidth(n.getRow(row));
+		int sum = getSum(n.getRow(row), width, n.getWidth());
+		for (vector<int> optionGaps : getLineSet(width, sum))
+			rowOptions.insert( decodeLineSet(optionGaps, n.getRow(row), n.getWidth()) ); //insert the key and value (gap vector, row char vector) into the map
+
+		options[row] = rowOptions;
+	}
+	return options;
+}
+vector<set<vector<char>>> getColumnOptions(const Nonogram& n)
+{
+	vector<set<vector<char>>> options(n.getWidth()); //size
+	for (int column = 0; column < n.getWidth(); column++)
+	{
+		set< vector<char> > columnOptions;
+		int width = getWidth(n.getColumn(column));
+		int sum = getSum(n.getColumn(column), width, n.getHeight());
+		for (vector<int> optionGaps : getLineSet(width, sum))
+			columnOptions.insert( decodeLineSet(optionGaps, n.getColumn(column), n.getHeight()) ); //insert the key and value (gap vector, row char vector) into the map
+
+		options[column] = columnOptions;
+	}
+	return options;
+}
+
+bool revise(int sourceIndex, int destIndex, set<vector<char>>& sourceDomain, const set<vector<char>>& destDomain)
+{
+	bool isRevised = false;
+	for (auto iter = sourceDomain.begin(); iter != sourceDomain.end();)
+	{
+		vector<char> sourceOption = *iter; //the option from the iterator
+		bool optionIsRevised = true; //assume revision for option until disproven
+		for (vector<char> destOption : destDomain)
+			if (sourceOption[destIndex] == destOption[sourceIndex]) //if match then option is possible
+			{
+				optionIsRevised = false;
+				break;
+			}
+		if (optionIsRevised)
+		{
+			iter = sourceDomain.erase(iter); //delete this option by iterator, make sure iter value stays consistent
+			isRevised = true;
+		}
+		else
+			++iter; //if we don't remove an element we can move the iterator forward
+	}
+	return isRevised;
+}
+
+bool arcConsistency(vector<set<vector<char>>>& rowDomain, vector<set<vector<char>>>& columnDomain)
+{
+	queue<arcType> toRevise; //list of things to revise
+	for(int rowI = 0; rowI < rowDomain.size(); rowI++) //put all possible row column options to initially revise
+		for (int colI = 0; colI < columnDomain.size(); colI++)
+		{
+			//put both types of revision on the queue
+			toRevise.push( arcType{rowI, colI, true} );
+			toRevise.push( arcType{colI, rowI, false} );
+		}
+
+	while (!toRevise.empty()) //while revisions are still necessary
+	{
+		arcType arcRevise = toRevise.front();
+		toRevise.pop(); //remove elmeent
+
+		bool revised; //if a revision happened
+		if (arcRevise.sourceIsRow)
+			revised = revise(arcRevise.source, arcRevise.destination, rowDomain[arcRevise.source], columnDomain[arcRevise.destination]);
+		else //source is a column
+			revised = revise(arcRevise.source, arcRevise.destination, columnDomain[arcRevise.source], rowDomain[arcRevise.destination]);
+
+		if (revised)
+		{
+			//if the new domain of the source is null, then we have an inconsistent nonogram
+			if (arcRevise.sourceIsRow && rowDomain[arcRevise.source].empty())
+				return false;
+			else if (!arcRevise.sourceIsRow && columnDomain[arcRevise.source].empty()) //arcRevise source is a columnIndex
+				return false;
+
+			//since the domain of source is now smaller we have to revise all the domains it affects
+			if (arcRevise.sourceIsRow)
+				for (int colI = 0; colI < columnDomain.size(); colI++)
+					toRevise.push( arcType{ colI, arcRevise.source, false } );
+			else //source is a column
+				for (int rowI = 0; rowI < rowDomain.size(); rowI++)
+					toRevise.push( arcType{ rowI, arcRevise.source, true } );
+		}
+	}
+	return true; //consistent
+}
+
+void backtrack(vector<set<vector<char>>>& rowDomain, vector<set<vector<char>>>& columnDomain, vector<bool>& rowAssign, vector<bool>& columnAssign)
+{
+	backtrackNodes++;
+	if (domainsAreSingular(rowDomain, columnDomain, rowAssign, columnAssign)) //solution found
+		return;
+
+	int smallestRowIndex = 0;
+	int smallestRowSize = INT_MAX;
+	for (int i = 0; i < rowDomain.size(); i++)
+		if (!rowAssign[i] && rowDomain[i].size() < smallestRowSize)
+		{
+			smallestRowIndex = i;
+			smallestRowSize = rowDomain[i].size();
+		}
+	
+	int smallestColumnIndex = 0;
+	int smallestColumnSize = INT_MAX;
+	for (int i = 0; i < columnDomain.size(); i++)
+		if (!columnAssign[i] && columnDomain[i].size() < smallestColumnSize)
+		{
+			smallestColumnIndex = i;
+			smallestColumnSize = columnDomain[i].size();
+		}
+	
+	if (smallestRowSize < smallestColumnSize)
+		return assignRowBacktrack(smallestRowIndex, rowDomain, columnDomain, rowAssign, columnAssign); //row is assigned
+	else //smallestColumnSize <= smallestRowSize
+		return assignColumnBacktrack(smallestColumnIndex, rowDomain, columnDomain, rowAssign, columnAssign); //inverted order, so column is assigned
+}
+
+void assignRowBacktrack(int rowIndex, vector<set<vector<char>>>& rowDomain, vector<set<vector<char>>>& columnDomain, vector<bool>& rowAssign, vector<bool>& columnAssign)
+{
+	rowAssign[rowIndex] = true;
+	for (auto iter = rowDomain[rowIndex].begin(); iter != rowDomain[rowIndex].end(); ++iter)
+	{
+		vector<char> assign = *iter;
+
+		set<vector<char>> oldRowDomain = rowDomain[rowIndex];
+		rowDomain[rowIndex] = { assign }; //new domain for tihs row is just the assignment
+		
+		vector<set<vector<char>>> newColumnsDomain = columnDomain;
+		//take away newly restriced domain values
+		for (int i = 0; i < newColumnsDomain.size(); i++) //go through each column set
+			revise(i, rowIndex, newColumnsDomain[i], rowDomain[rowIndex]);
+
+		backtrack(rowDomain, newColumnsDomain, rowAssign, columnAssign); //continue seraching
+		
+		if (domainsAreSingular(rowDomain, newColumnsDomain, rowAssign, columnAssign))
+		{
+			columnDomain = newColumnsDomain; //set the newColumn domain
+			return; //valid solution
+		}
+
+		//revert assignment
+		rowDomain[rowIndex] = oldRowDomain;
+		iter = rowDomain[rowIndex].find(assign);
+	}
+	rowAssign[rowIndex] = false;
+	return; //failure
+}
+void assignColumnBacktrack(int columnIndex, vector<set<vector<char>>>& rowDomain, vector<set<vector<char>>>& columnDomain, vector<bool>& rowAssign, vector<bool>& columnAssign)
+{
+	columnAssign[columnIndex] = true;
+	for (auto iter = columnDomain[columnIndex].begin(); iter != columnDomain[columnIndex].end(); ++iter)
+	{
+		vector<char> assign = *iter;
+
+		set<vector<char>> oldColumnDomain = columnDomain[columnIndex];
+		columnDomain[columnIndex] = { assign }; //new domain for tihs row is just the assignment
+		
+		vector<set<vector<char>>> newRowsDomain = rowDomain;
+		//take away newly restriced domain values
+		for (int i = 0; i < newRowsDomain.size(); i++) //go through each row set
+			revise(i, columnIndex, newRowsDomain[i], columnDomain[columnIndex]);
+
+		backtrack(newRowsDomain, columnDomain, rowAssign, columnAssign); //continue seraching
+
+		if (domainsAreSingular(newRowsDomain, columnDomain, rowAssign, columnAssign))
+		{
+			rowDomain = newRowsDomain; //set the newColumn domain
+			return; //valid solution
+		}
+
+		//revert assignment
+		columnDomain[columnIndex] = oldColumnDomain;
+		iter = columnDomain[columnIndex].find(assign);
+	}
+	columnAssign[columnIndex] = false;
+	return; //failure
+}
+
+bool domainsAreSingular(vector<set<vector<char>>>& rowDomain, vector<set<vector<char>>>& columnDomain, vector<bool>& rowAssign, vector<bool>& columnAssign)
+{
+	for (bool assign : rowAssign)
+		if (!assign)
+			return false;
+
+	for (bool assign : columnAssign)
+		if (!assign)
+			return false;
+
+	for (set<vector<char>> rowsOptions : rowDomain)
+		if (rowsOptions.size() > 1 || rowsOptions.empty()) //if multiple or no options are left, then the nonogram was invalid
+			return false;
+	for (set<vector<char>> columnsOptions : columnDomain)
+		if (columnsOptions.size() > 1 || columnsOptions.empty()) //if multiple or no options are left, then the nonogram was invalid
+			return false;
+
+	return true; //solved!
+}
+} //end namespace setSolver
@@ -0,0 +1,27 @@
+//the original solver with every domain held in a set<vector<char>>, kept as the reference for benchmarks
+#ifndef SETSOLVER_H
+#define SETSOLVER_H
+
+#include "Solver.h"
+#include <set>
+#include <vector>
+using std::set;
+using std::vector;
+
+namespace setSolver
+{
+	vector<set<vector<char>>> getRowOptions(const Nonogram& n);
+	vector<set<vector<char>>> getColumnOptions(const Nonogram& n);
+
+	bool revise(int sourceIndex, int destIndex, set<vector<char>>& sourceDomain, const set<vector<char>>& destDomain);
+	bool arcConsistency(vector<set<vector<char>>>& rowDomain, vector<set<vector<char>>>& columnDomain);
+	bool domainsAreSingular(vector<set<vector<char>>>& rowDomain, vector<set<vector<char>>>& columnDomain, vector<bool>& rowAssign, vector<bool>& columnAssign);
+
+	extern long long backtrackNodes; //calls to backtrack, only counted for benchmarks
+
+	void backtrack(vector<set<vector<char>>>& rowDomain, vector<set<vector<char>>>& columnDomain, vector<bool>& rowAssign, vector<bool>& columnAssign);
+	void assignRowBacktrack(int rowIndex, vector<set<vector<char>>>& rowDomain, vector<set<vector<char>>>& columnDomain, vector<bool>& rowAssign, vector<bool>& columnAssign);
+	void assignColumnBacktrack(int columnIndex, vector<set<vector<char>>>& rowDomain, vector<set<vector<char>>>& columnDomain, vector<bool>& rowAssign, vector<bool>& columnAssign);
+}
+
+#endif
@@ -0,0 +1,20 @@
+#include "SmallSolver.h"
+using namespace std;
+
+bool hasSmallSolver(int width, int height)
+{
+	return width == height && (width == 5 || width == 10 || width == 15);
+}
+
+bool solveSmall(Nonogram& n, SearchStats& stats)
+{
+	switch (n.getWidth())
+	{
+		case 5:
+			return SmallSolver<5, 5>(n).solve(n, stats);
+		case 10:
+			return SmallSolver<10, 10>(n).solve(n, stats);
+		default:
+			return SmallSolver<15, 15>(n).solve(n, stats);
+	}
+}
@@ -0,0 +1,243 @@
+//line solving for boards of a fixed small size, every line a 16 bit mask and every placement read from a compile time table
+#ifndef SMALLSOLVER_H
+#define SMALLSOLVER_H
+
+#include "Nonogram.h"
+#include "Solver.h"
+#include "CellKernel.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+using std::array;
+using std::uint16_t;
+using std::uint64_t;
+using std::vector;
+
+constexpr int clueCount(int width) //clues that fit a line of the width, fibonacci(width + 2)
+{
+	int previous = 1, current = 1;
+	for (int i = 0; i < width; i++)
+	{
+		int next = previous + current;
+		previous = current;
+		current = next;
+	}
+	return current;
+}
+
+//every one of the 2^width lines grouped by its clue. clues are kept in lexicographic order, each packed 4 bits a block
+//from the top so that the packed numbers sort the same way, and placements of clue c are lines[starts[c]..starts[c + 1])
+template <int width>
+struct PlacementTable
+{
+	static_assert(width >= 1 && width <= 15, "blocks are packed in 4 bits and lines in 16");
+	static constexpr int clues = clueCount(width);
+
+	array<uint16_t, (1 << width)> lines{};
+	array<uint64_t, clues> codes{};
+	array<int, clues + 1> starts{};
+
+	constexpr PlacementTable()
+	{
+		int clue[(width + 1) / 2] = {};
+		int clueIndex = 0, lineIndex = 0;
+		addClues(clue, 0, 0, 0, clueIndex, lineIndex);
+		starts[clues] = lineIndex;
+	}
+
+	//placements of the clue as [begin, end), false if no line of this width has it
+	bool find(const vector<int>& clue, int& begin, int& end) const
+	{
+		if (clue.size() > (width + 1) / 2)
+			return false;
+		uint64_t code = 0;
+		for (int i = 0; i < clue.size(); i++)
+		{
+			if (clue[i] < 1 || clue[i] > width)
+				return false;
+			code |= uint64_t(clue[i]) << (60 - 4 * i);
+		}
+		const uint64_t* found = std::lower_bound(codes.data(), codes.data() + clues, code);
+		if (found == codes.data() + clues || *found != code)
+			return false;
+		begin = starts[found - codes.data()];
+		end = starts[found - codes.data() + 1];
+		return true;
+	}
+
+private:
+	//the clue so far, then every clue extending it, preorder so the codes come out sorted
+	constexpr void addClues(int* clue, int blocks, int minimum, uint64_t code, int& clueIndex, int& lineIndex)
+	{
+		codes[clueIndex] = code;
+		starts[clueIndex] = lineIndex;
+		clueIndex++;
+		addPlacements(clue, blocks, 0, 0, 0, lineIndex);
+
+		for (int block = 1; (blocks == 0 ? block : minimum + 1 + block) <= width; block++)
+		{
+			clue[blocks] = block;
+			addClues(clue, blocks + 1, blocks == 0 ? block : minimum + 1 + block, code | uint64_t(block) << (60 - 4 * blocks), clueIndex, lineIndex);
+		}
+	}
+
+	constexpr void addPlacements(const int* clue, int blocks, int block, int start, uint16_t line, int& lineIndex)
+	{
+		if (block == blocks)
+		{
+			lines[lineIndex++] = line;
+			return;
+		}
+		int rest = blocks - block - 1; //the cells the blocks after this one need, one empty cell before each included
+		for (int i = block + 1; i < blocks; i++)
+			rest += clue[i];
+		for (int cell = start; cell + clue[block] + rest <= width; cell++)
+			addPlacements(clue, blocks, block + 1, cell + clue[block] + 1, (uint16_t)(line | ((1 << clue[block]) - 1) << cell), lineIndex);
+	}
+};
+
+template <int width>
+inline constexpr PlacementTable<width> placementTable{};
+
+//lineSearch with the board size fixed at compile time: the known cells are filled and empty masks per row and column,
+//a guess copies them on the stack, and nothing is allocated once the clues are looked up
+template <int width, int height>
+class SmallSolver
+{
+	public:
+		explicit SmallSolver(const Nonogram& n)
+		{
+			consistent = true;
+			for (int y = 0; y < height; y++)
+				consistent = consistent && placementTable<width>.find(n.getRow(y), rowBegin[y], rowEnd[y]);
+			for (int x = 0; x < width; x++)
+				consistent = consistent && placementTable<height>.find(n.getColumn(x), columnBegin[x], columnEnd[x]);
+		}
+
+		bool solve(Nonogram& n, SearchStats& stats)
+		{
+			Cells cells{};
+			if (!consistent || !propagate(cells, (1u << height) - 1, (1u << width) - 1) || !guessCells(cells, stats))
+				return false;
+			for (int x = 0; x < width; x++)
+				for (int y = 0; y < height; y++)
+					n[x][y] = (cells.rowFilled[y] >> x) & 1 ? 'X' : ' '; //solutions leave empty cells blank like the domain solver
+			return true;
+		}
+	private:
+		struct Cells //bit x of row y and bit y of column x are the same cell
+		{
+			array<uint16_t, height> rowFilled, rowEmpty;
+			array<uint16_t, width> columnFilled, columnEmpty;
+		};
+
+		//solveLine over the table: the known masks become the cells every placement agreeing with them shares
+		template <int length>
+		static bool settle(int begin, int end, uint16_t& filled, uint16_t& empty)
+		{
+			uint16_t always = (1 << length) - 1, ever = 0;
+			bool placed = false;
+			for (int i = begin; i < end; i++)
+			{
+				uint16_t line = placementTable<length>.lines[i];
+				if ((line & empty) || (line & filled) != filled)
+					continue;
+				always &= line;
+				ever |= line;
+				placed = true;
+			}
+			filled = always;
+			empty = (uint16_t)(~ever & ((1 << length) - 1));
+			return placed;
+		}
+
+		//solve the dirty rows and columns until nothing changes, bit i of a dirty mask is line i
+		bool propagate(Cells& cells, unsigned dirtyRows, unsigned dirtyColumns) const
+		{
+			while (dirtyRows || dirtyColumns)
+			{
+				if (dirtyRows)
+				{
+					int y = countTrailingZeros(dirtyRows);
+					dirtyRows &= dirtyRows - 1;
+					uint16_t filled = cells.rowFilled[y], empty = cells.rowEmpty[y];
+					if (!settle<width>(rowBegin[y], rowEnd[y], filled, empty))
+						return false;
+					for (unsigned changed = (filled & ~cells.rowFilled[y]) | (empty & ~cells.rowEmpty[y]); changed; changed &= changed - 1)
+					{
+						int x = countTrailingZeros(changed);
+						((filled >> x) & 1 ? cells.columnFilled : cells.columnEmpty)[x] |= 1 << y;
+						dirtyColumns |= 1u << x;
+					}
+					cells.rowFilled[y] = filled;
+					cells.rowEmpty[y] = empty;
+				}
+				else
+				{
+					int x = countTrailingZeros(dirtyColumns);
+					dirtyColumns &= dirtyColumns - 1;
+					uint16_t filled = cells.columnFilled[x], empty = cells.columnEmpty[x];
+					if (!settle<height>(columnBegin[x], columnEnd[x], filled, empty))
+						return false;
+					for (unsigned changed = (filled & ~cells.columnFilled[x]) | (empty & ~cells.columnEmpty[x]); changed; changed &= changed - 1)
+					{
+						int y = countTrailingZeros(changed);
+						((filled >> y) & 1 ? cells.rowFilled : cells.rowEmpty)[y] |= 1 << x;
+						dirtyRows |= 1u << y;
+					}
+					cells.columnFilled[x] = filled;
+					cells.columnEmpty[x] = empty;
+				}
+			}
+			return true;
+		}
+
+		//cells is already propagated, guess the unknown cell whose row and column have the fewest unknowns left like guessCells
+		bool guessCells(Cells& cells, SearchStats& stats) const
+		{
+			int rowUnknown[height], columnUnknown[width];
+			for (int y = 0; y < height; y++)
+				rowUnknown[y] = width - countBits(cells.rowFilled[y] | cells.rowEmpty[y]);
+			for (int x = 0; x < width; x++)
+				columnUnknown[x] = height - countBits(cells.columnFilled[x] | cells.columnEmpty[x]);
+
+			int guessX = -1, guessY = -1;
+			int fewest = width + height + 1;
+			for (int x = 0; x < width; x++)
+				for (int y = 0; y < height; y++)
+					if (!(((cells.rowFilled[y] | cells.rowEmpty[y]) >> x) & 1) && std::min(rowUnknown[y], columnUnknown[x]) < fewest)
+					{
+						guessX = x;
+						guessY = y;
+						fewest = std::min(rowUnknown[y], columnUnknown[x]);
+					}
+			if (guessX == -1) //every cell known and every line consistent
+				return true;
+			if (stats.limitReached())
+				return false;
+			stats.nodes++;
+
+			for (bool filled : { true, false })
+			{
+				Cells guess = cells;
+				(filled ? guess.rowFilled : guess.rowEmpty)[guessY] |= 1 << guessX;
+				(filled ? guess.columnFilled : guess.columnEmpty)[guessX] |= 1 << guessY;
+				if (propagate(guess, 1u << guessY, 1u << guessX) && guessCells(guess, stats))
+				{
+					cells = guess;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		bool consistent; //false when some clue does not fit its line
+		array<int, height> rowBegin, rowEnd;
+		array<int, width> columnBegin, columnEnd;
+};
+
+bool hasSmallSolver(int width, int height); //5x5, 10x10 and 15x15
+bool solveSmall(Nonogram& n, SearchStats& stats); //SmallSolver for the size of n, which hasSmallSolver has to accept
+
+#endif
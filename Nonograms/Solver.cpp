@@ -0,0 +1,881 @@
+#include "Solver.h"
+#include "SupportCounter.h"
+#include "LineSolver.h"
+#include "BoundedDomains.h"
+#include "MemoryTracker.h"
+#include "ParallelSearch.h"
+#include "PlacementEnumerator.h"
+#include "SmallSolver.h"
+#include "SatSolver.h"
+#include "Portfolio.h"
+#include "Arena.h"
+#include <algorithm>
+#include <iostream>
+#include <queue>
+#include <climits>
+#include <cmath>
+#include <chrono>
+using namespace std;
+
+//setup functions
+set< vector<int> > getLineSet(int width, int sum)
+{
+	set<vector<int>> options = getLineSetRecursive(width, sum); //basic sets
+	set<vector<int>> formattedSet; //the non first last elmements in each vector be added by one
+	for (vector<int> option : options)
+	{
+		for (int i = 1; i < option.size() - 1; i++) //every element but the 0th and last
+			++option[i];
+		formattedSet.insert(option);
+	}
+	return formattedSet;
+}
+set< vector<int> > getLineSetRecursive(int width, int sum)
+{
+	set<vector<int>> options;
+	if (width == 1) //end case
+	{
+		options.insert( { sum } );
+		return options;
+	}
+
+	for (int i = 0; i <= sum; i++) //recursive
+	{
+		set<vector<int>> subSet = getLineSetRecursive(width-1, sum-i);
+		for (const vector<int>& subOption : subSet)
+		{
+			vector<int> option = { i };
+			option.reserve(1 + subOption.size()); // preallocate memory
+			option.insert(option.end(), subOption.begin(), subOption.end()); //add sub vector to the end of the vector
+			options.insert(option);
+		}
+	}
+	return options;
+}
+
+vector<char> decodeLineSet(const vector<int>& gaps, const vector<int>& streak, int width)
+{
+	vector<char> line(width, ' '); //empty line
+	int i = 0;
+	int streakIndex = 0;
+	int gapIndex = 0;
+	while(gapIndex < gaps.size() && streakIndex < streak.size() && i < width)
+	{
+		i = i + gaps[gapIndex]; //skip the gap
+
+		int startStreakIndex = i;
+		for (; i < startStreakIndex + streak[streakIndex]; i++) //fill in the streak
+			line[i] = 'X';
+
+		streakIndex++; //move to the next streak
+		gapIndex++; //move to the next gap
+	}
+
+	return line;
+}
+
+int getWidth(const vector<int>& streaks)
+{
+	return streaks.size() + 1;
+}
+int getSum(const vector<int>& streaks, int width, int lineWidth)
+{
+	int streakSum = 0;
+	for (int streak : streaks)
+		streakSum = streakSum + streak;
+
+	if (width > 2)
+		return lineWidth - streakSum - (width - 2);
+	else //width is 1
+		return lineWidth - streakSum;
+}
+
+vector<LineDomain> getRowOptions(const Nonogram& n)
+{
+	vector<LineDomain> options; //size
+	options.reserve(n.getHeight());
+	for (int row = 0; row < n.getHeight(); row++)
+	{
+		LineDomain rowOptions(n.getWidth());
+		vector<char> line(n.getWidth());
+		for (PlacementEnumerator placement(n.getRow(row), n.getWidth()); !placement.done(); placement.next())
+		{
+			placement.writeLine(line.data());
+			rowOptions.addLine(line); //pack the decoded line into the domain
+		}
+
+		options.push_back(move(rowOptions));
+	}
+	return options;
+}
+vector<LineDomain> getColumnOptions(const Nonogram& n)
+{
+	vector<LineDomain> options; //size
+	options.reserve(n.getWidth());
+	for (int column = 0; column < n.getWidth(); column++)
+	{
+		LineDomain columnOptions(n.getHeight());
+		vector<char> line(n.getHeight());
+		for (PlacementEnumerator placement(n.getColumn(column), n.getHeight()); !placement.done(); placement.next())
+		{
+			placement.writeLine(line.data());
+			columnOptions.addLine(line); //pack the decoded line into the domain
+		}
+
+		options.push_back(move(columnOptions));
+	}
+	return options;
+}
+//end setup functions
+
+
+//Constraint Satisfaction Problem functions
+bool revise(int sourceIndex, int destIndex, LineDomain& sourceDomain, const LineDomain& destDomain)
+{
+	//an option survives when some destination option matches it on the crossing cell, so only a value the destination
+	//never takes there removes anything, and it removes every option taking it
+	int destFilled = destDomain.countCell(sourceIndex, true);
+	bool isRevised = false;
+	if (destFilled == 0)
+		isRevised = sourceDomain.removeCell(destIndex, true) > 0;
+	if (destFilled == destDomain.size())
+		isRevised = sourceDomain.removeCell(destIndex, false) > 0 || isRevised;
+	return isRevised;
+}
+
+bool arcConsistency(vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain)
+{
+	PropagationStats stats;
+	return arcConsistency(rowDomain, columnDomain, stats);
+}
+
+struct pendingArc //a source line to revise against one destination line crossing it
+{
+	int size; //live candidates of the source when queued
+	int source;
+	int destination;
+	bool sourceIsRow;
+
+	bool operator>(const pendingArc& other) const { return size > other.size; }
+};
+
+bool arcConsistency(vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain, PropagationStats& stats)
+{
+	int rows = rowDomain.size(), columns = columnDomain.size();
+	ArenaFrame frame; //the queue and its flags are gone once the arcs are consistent
+	//smallest source first, its revisions are the cheapest and the most likely to empty or force cells
+	priority_queue<pendingArc, ArenaVector<pendingArc>, greater<pendingArc>> toRevise;
+	ArenaVector<bool> rowArcQueued(rows * columns, true), columnArcQueued(columns * rows, true); //[source * crossing + destination]
+	for (int rowI = 0; rowI < rows; rowI++) //put all possible row column options to initially revise
+		for (int colI = 0; colI < columns; colI++)
+		{
+			toRevise.push(pendingArc{ rowDomain[rowI].size(), rowI, colI, true });
+			toRevise.push(pendingArc{ columnDomain[colI].size(), colI, rowI, false });
+		}
+	stats.queuePeak = max(stats.queuePeak, toRevise.size());
+
+	//the cells each line's candidates agree on. revise only looks at the crossing cell, so an arc into a line needs
+	//revising again only when that line's agreement on the crossing cell changes
+	vector<vector<char>> rowForced(rows, vector<char>(columns, ' ')), columnForced(columns, vector<char>(rows, ' '));
+	for (int rowI = 0; rowI < rows; rowI++)
+		rowDomain[rowI].fillForced(rowForced[rowI]);
+	for (int colI = 0; colI < columns; colI++)
+		columnDomain[colI].fillForced(columnForced[colI]);
+
+	vector<char> forced;
+	while (!toRevise.empty()) //while revisions are still necessary
+	{
+		pendingArc arc = toRevise.top();
+		toRevise.pop();
+		int crossing = arc.sourceIsRow ? columns : rows;
+		(arc.sourceIsRow ? rowArcQueued : columnArcQueued)[arc.source * crossing + arc.destination] = false;
+		LineDomain& source = (arc.sourceIsRow ? rowDomain : columnDomain)[arc.source];
+
+		stats.revisions++;
+		if (!revise(arc.source, arc.destination, source, (arc.sourceIsRow ? columnDomain : rowDomain)[arc.destination]))
+			continue;
+		if (source.empty()) //if the new domain of the source is null, then we have an inconsistent nonogram
+			return false;
+
+		forced.assign(crossing, ' ');
+		source.fillForced(forced);
+		vector<char>& previous = (arc.sourceIsRow ? rowForced : columnForced)[arc.source];
+		vector<LineDomain>& crossingDomain = arc.sourceIsRow ? columnDomain : rowDomain;
+		ArenaVector<bool>& crossingQueued = arc.sourceIsRow ? columnArcQueued : rowArcQueued;
+		int sourceCount = arc.sourceIsRow ? rows : columns; //lines parallel to the source, the crossing lines' crossings
+		for (int cell = 0; cell < crossing; cell++)
+			if (forced[cell] != previous[cell] && !crossingQueued[cell * sourceCount + arc.source])
+			{
+				crossingQueued[cell * sourceCount + arc.source] = true;
+				toRevise.push(pendingArc{ crossingDomain[cell].size(), cell, arc.source, !arc.sourceIsRow });
+			}
+		previous.swap(forced);
+		stats.queuePeak = max(stats.queuePeak, toRevise.size());
+	}
+	return true; //consistent
+}
+
+bool supportConsistency(vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain)
+{
+	SupportCounter counter(rowDomain, columnDomain);
+	return counter.propagate();
+}
+
+bool propagate(vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain, Propagation mode)
+{
+	if (mode == ARC_CONSISTENCY)
+		return arcConsistency(rowDomain, columnDomain);
+	return supportConsistency(rowDomain, columnDomain); //line and sat solving have no domains, counting is the closest domain propagation
+}
+
+bool backtrack(vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain, vector<bool>& rowAssign, vector<bool>& columnAssign)
+{
+	vector<trailType> trail;
+	SearchStats stats;
+	return backtrack(rowDomain, columnDomain, rowAssign, columnAssign, trail, stats);
+}
+
+//remove a candidate and remember it so undoTrail can put it back
+static void trailRemove(LineDomain& domain, int line, bool isRow, int option, vector<trailType>& trail)
+{
+	domain.remove(option);
+	trail.push_back(trailType{ line, option, isRow });
+}
+
+//a line emptied while another was assigned, both weigh more for BRANCH_WEIGHTED_DEGREE
+static void recordFailure(SearchStats& stats, int line, int cross)
+{
+	stats.lineWeights[line] += stats.weightIncrement;
+	stats.lineWeights[cross] += stats.weightIncrement;
+	stats.weightIncrement /= 0.95;
+	if (stats.weightIncrement > 1e100)
+	{
+		for (double& weight : stats.lineWeights)
+			weight *= 1e-100;
+		stats.weightIncrement *= 1e-100;
+	}
+}
+
+//the candidates of a line, most promising first: each scores the share of every crossing line's candidates that agree
+//with it at their shared cell, multiplied together, so a candidate no crossing line can meet goes last
+static void orderBySupport(const LineDomain& domain, int index, const vector<LineDomain>& crossDomain, ArenaVector<int>& options)
+{
+	static thread_local vector<double> filledShare;
+	static thread_local vector<pair<double, int>> scored;
+	filledShare.resize(crossDomain.size());
+	for (int i = 0; i < crossDomain.size(); i++)
+		filledShare[i] = crossDomain[i].empty() ? 0 : (double)crossDomain[i].countCell(index, true) / crossDomain[i].size();
+
+	scored.clear();
+	for (int option : options)
+	{
+		double score = 0;
+		for (int i = 0; i < crossDomain.size() && score != -HUGE_VAL; i++)
+			score += log(domain.isFilled(option, i) ? filledShare[i] : 1 - filledShare[i]);
+		scored.push_back({ -score, option });
+	}
+	stable_sort(scored.begin(), scored.end(), [](const pair<double, int>& a, const pair<double, int>& b) { return a.first < b.first; });
+	for (int i = 0; i < options.size(); i++)
+		options[i] = scored[i].second;
+}
+
+//forward checking for cell splits: every cell a queued line's live candidates agree on takes the candidates that disagree
+//out of the crossing line, which is queued in turn, until nothing changes. lines are numbered rows first. false once a
+//domain is empty, the removals are on the trail either way
+static bool propagateCells(vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain, vector<int>& queue, vector<trailType>& trail)
+{
+	int rows = rowDomain.size();
+	static thread_local vector<char> queued;
+	static thread_local vector<uint64_t> disagree;
+	queued.assign(rows + columnDomain.size(), false);
+	for (int line : queue)
+		queued[line] = true;
+	while (!queue.empty())
+	{
+		int line = queue.back();
+		queue.pop_back();
+		queued[line] = false;
+		bool isRow = line < rows;
+		int index = isRow ? line : line - rows;
+		LineDomain& domain = (isRow ? rowDomain : columnDomain)[index];
+		vector<LineDomain>& crossDomain = isRow ? columnDomain : rowDomain;
+		for (int cell = 0; cell < crossDomain.size(); cell++)
+		{
+			int filled = domain.countCell(cell, true);
+			if (filled != 0 && filled != domain.size()) //the line has not decided the cell
+				continue;
+			LineDomain& cross = crossDomain[cell];
+			cross.selectCell(index, filled == 0, disagree);
+			bool pruned = false;
+			for (int option = LineDomain::next(disagree, -1); option != -1; option = LineDomain::next(disagree, option))
+			{
+				trailRemove(cross, cell, !isRow, option, trail);
+				pruned = true;
+			}
+			if (cross.empty())
+			{
+				queue.clear();
+				return false;
+			}
+			int crossLine = isRow ? rows + cell : cell;
+			if (pruned && !queued[crossLine])
+			{
+				queued[crossLine] = true;
+				queue.push_back(crossLine);
+			}
+		}
+	}
+	return true;
+}
+
+//BRANCH_CONTESTED_CELL: a singular line is assigned as soon as there is one, so its crossings learn it. otherwise the cell
+//of an unassigned line whose candidates are the most evenly split is decided one way and then the other, taking the
+//candidates that disagree out of its row and its column and forward checking from there with propagateCells
+static bool cellBacktrack(vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain, vector<bool>& rowAssign, vector<bool>& columnAssign, vector<trailType>& trail, SearchStats& stats)
+{
+	int bestLine = -1, bestCell = -1;
+	bool bestIsRow = true;
+	double bestBalance = -1;
+	for (bool isRow : { true, false })
+	{
+		vector<LineDomain>& lineDomain = isRow ? rowDomain : columnDomain;
+		vector<bool>& lineAssign = isRow ? rowAssign : columnAssign;
+		for (int i = 0; i < lineDomain.size(); i++)
+		{
+			if (lineAssign[i])
+				continue;
+			int size = lineDomain[i].size();
+			if (size <= 1) //nothing left to split, empty ones fail in assignBacktrack
+				return assignBacktrack(i, isRow, rowDomain, columnDomain, rowAssign, columnAssign, trail, stats);
+			int length = (isRow ? columnDomain : rowDomain).size();
+			for (int cell = 0; cell < length; cell++)
+			{
+				int filled = lineDomain[i].countCell(cell, true);
+				double balance = (double)min(filled, size - filled) / size;
+				if (balance > bestBalance)
+				{
+					bestLine = i;
+					bestCell = cell;
+					bestIsRow = isRow;
+					bestBalance = balance;
+				}
+			}
+		}
+	}
+
+	//the row and column of the cell, each given as its line and the cell's index in it
+	int row = bestIsRow ? bestLine : bestCell, column = bestIsRow ? bestCell : bestLine;
+	bool values[] = { true, false };
+	if (stats.supportOrder) //the value more of the row's and column's candidates have first
+	{
+		int filled = rowDomain[row].countCell(column, true) + columnDomain[column].countCell(row, true);
+		if (2 * filled < rowDomain[row].size() + columnDomain[column].size())
+			swap(values[0], values[1]);
+	}
+
+	size_t mark = trail.size();
+	for (bool filled : values)
+	{
+		static thread_local vector<uint64_t> disagree;
+		rowDomain[row].selectCell(column, !filled, disagree);
+		for (int option = LineDomain::next(disagree, -1); option != -1; option = LineDomain::next(disagree, option))
+			trailRemove(rowDomain[row], row, true, option, trail);
+		columnDomain[column].selectCell(row, !filled, disagree);
+		for (int option = LineDomain::next(disagree, -1); option != -1; option = LineDomain::next(disagree, option))
+			trailRemove(columnDomain[column], column, false, option, trail);
+		static thread_local vector<int> queue;
+		queue.assign({ row, (int)rowDomain.size() + column });
+		bool consistent = !rowDomain[row].empty() && !columnDomain[column].empty() && propagateCells(rowDomain, columnDomain, queue, trail);
+		stats.trailPeak = max(stats.trailPeak, trail.size());
+
+		if (consistent && backtrack(rowDomain, columnDomain, rowAssign, columnAssign, trail, stats))
+			return true;
+		undoTrail(rowDomain, columnDomain, trail, mark);
+		if (stats.limitReached())
+			break;
+	}
+	return false;
+}
+
+bool backtrack(vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain, vector<bool>& rowAssign, vector<bool>& columnAssign, vector<trailType>& trail, SearchStats& stats)
+{
+	stats.nodes++;
+	if (domainsAreSingular(rowDomain, columnDomain, rowAssign, columnAssign)) //solution found
+		return true;
+	if (stats.limitReached())
+		return false;
+	if (stats.branching == BRANCH_CONTESTED_CELL)
+		return cellBacktrack(rowDomain, columnDomain, rowAssign, columnAssign, trail, stats);
+	if (stats.branching == BRANCH_WEIGHTED_DEGREE)
+	{
+		stats.lineWeights.resize(rowDomain.size() + columnDomain.size(), 0);
+		int line = -1;
+		double best = 0;
+		for (int i = 0; i < stats.lineWeights.size(); i++)
+		{
+			bool isRow = i < rowDomain.size();
+			int index = isRow ? i : i - rowDomain.size();
+			if ((isRow ? rowAssign : columnAssign)[index])
+				continue;
+			double score = (1 + stats.lineWeights[i]) / (isRow ? rowDomain : columnDomain)[index].size(); //empty domains come first
+			if (line == -1 || score > best)
+			{
+				line = i;
+				best = score;
+			}
+		}
+		bool isRow = line < rowDomain.size();
+		return assignBacktrack(isRow ? line : line - rowDomain.size(), isRow, rowDomain, columnDomain, rowAssign, columnAssign, trail, stats);
+	}
+
+	int smallestRowIndex = 0;
+	int smallestRowSize = INT_MAX;
+	for (int i = 0; i < rowDomain.size(); i++)
+		if (!rowAssign[i] && rowDomain[i].size() < smallestRowSize)
+		{
+			smallestRowIndex = i;
+			smallestRowSize = rowDomain[i].size();
+		}
+	
+	int smallestColumnIndex = 0;
+	int smallestColumnSize = INT_MAX;
+	for (int i = 0; i < columnDomain.size(); i++)
+		if (!columnAssign[i] && columnDomain[i].size() < smallestColumnSize)
+		{
+			smallestColumnIndex = i;
+			smallestColumnSize = columnDomain[i].size();
+		}
+	
+	if (smallestRowSize < smallestColumnSize)
+		return assignBacktrack(smallestRowIndex, true, rowDomain, columnDomain, rowAssign, columnAssign, trail, stats); //row is assigned
+	else //smallestColumnSize <= smallestRowSize
+		return assignBacktrack(smallestColumnIndex, false, rowDomain, columnDomain, rowAssign, columnAssign, trail, stats); //inverted order, so column is assigned
+}
+
+void undoTrail(vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain, vector<trailType>& trail, size_t mark)
+{
+	while (trail.size() > mark)
+	{
+		const trailType& removed = trail.back();
+		(removed.isRow ? rowDomain : columnDomain)[removed.line].restore(removed.option);
+		trail.pop_back();
+	}
+}
+
+//a branch only records the candidates it removed, backtracking pops them instead of restoring copied domains
+bool assignBacktrack(int index, bool isRow, vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain, vector<bool>& rowAssign, vector<bool>& columnAssign, vector<trailType>& trail, SearchStats& stats)
+{
+	vector<LineDomain>& lineDomain = isRow ? rowDomain : columnDomain;
+	vector<LineDomain>& crossDomain = isRow ? columnDomain : rowDomain;
+	vector<bool>& lineAssign = isRow ? rowAssign : columnAssign;
+	LineDomain& domain = lineDomain[index];
+
+	lineAssign[index] = true;
+	size_t mark = trail.size();
+	ArenaFrame frame; //deeper levels take their candidates after these and give them back first
+	ArenaVector<int> options; //this level's candidates, the domain is cut down to each in turn
+	for (int option = domain.first(); option != -1; option = domain.next(option))
+		options.push_back(option);
+	if (stats.random)
+		shuffle(options.begin(), options.end(), *stats.random);
+	if (stats.supportOrder)
+		orderBySupport(domain, index, crossDomain, options);
+	for (int assign : options)
+	{
+		for (int option = domain.first(); option != -1; option = domain.next(option)) //new domain for this line is just the assignment
+			if (option != assign)
+				trailRemove(domain, index, isRow, option, trail);
+
+		//take away newly restriced domain values, each crossing line has to agree with the assignment at its cell
+		bool consistent = true;
+		for (int i = 0; i < crossDomain.size() && consistent; i++)
+		{
+			static thread_local vector<uint64_t> disagree;
+			LineDomain& cross = crossDomain[i];
+			cross.selectCell(index, !domain.isFilled(assign, i), disagree);
+			for (int option = LineDomain::next(disagree, -1); option != -1; option = LineDomain::next(disagree, option))
+				trailRemove(cross, i, !isRow, option, trail);
+			consistent = !cross.empty();
+			if (!consistent && stats.branching == BRANCH_WEIGHTED_DEGREE)
+				recordFailure(stats, isRow ? index : rowDomain.size() + index, isRow ? rowDomain.size() + i : i);
+		}
+		stats.trailPeak = max(stats.trailPeak, trail.size());
+
+		if (consistent && backtrack(rowDomain, columnDomain, rowAssign, columnAssign, trail, stats)) //continue seraching
+			return true; //valid solution, the trail is left in place
+
+		undoTrail(rowDomain, columnDomain, trail, mark); //revert assignment
+		if (stats.limitReached())
+			break;
+	}
+	lineAssign[index] = false;
+	return false; //failure
+}
+
+bool chooseSplit(const SupportCounter& counter, bool& isRow, int& line, int& cell)
+{
+	//branch on the smallest domain that is not yet decided, with full consistency every singular domain agrees with its crossings
+	line = -1;
+	int smallestSize = INT_MAX;
+	for (int i = 0; i < counter.rowCount(); i++)
+		if (counter.domain(true, i).size() > 1 && counter.domain(true, i).size() < smallestSize)
+		{
+			line = i;
+			isRow = true;
+			smallestSize = counter.domain(true, i).size();
+		}
+	for (int i = 0; i < counter.columnCount(); i++)
+		if (counter.domain(false, i).size() > 1 && counter.domain(false, i).size() < smallestSize)
+		{
+			line = i;
+			isRow = false;
+			smallestSize = counter.domain(false, i).size();
+		}
+	if (line == -1)
+		return false;
+
+	//split the domain on its most evenly divided cell
+	cell = 0;
+	int mostEven = -1;
+	for (int i = 0; i < counter.domain(isRow, line).length(); i++)
+	{
+		int even = min(counter.filledCount(isRow, line, i), counter.emptyCount(isRow, line, i));
+		if (even > mostEven)
+		{
+			mostEven = even;
+			cell = i;
+		}
+	}
+	return true;
+}
+
+//'X' or '-' for every cell the row domains agree on, 0 for the rest, row major
+static void decidedCells(const SupportCounter& counter, vector<char>& cells)
+{
+	int w = counter.columnCount();
+	cells.resize((size_t)counter.rowCount() * w);
+	for (int y = 0; y < counter.rowCount(); y++)
+		for (int x = 0; x < w; x++)
+		{
+			int filled = counter.filledCount(true, y, x);
+			cells[y * w + x] = filled == 0 ? '-' : filled == counter.domain(true, y).size() ? 'X' : 0;
+		}
+}
+
+static void fixCell(SupportCounter& counter, int y, int x, bool filled)
+{
+	static thread_local vector<uint64_t> disagree;
+	counter.domain(true, y).selectCell(x, !filled, disagree);
+	for (int option = LineDomain::next(disagree, -1); option != -1; option = LineDomain::next(disagree, option))
+		counter.remove(true, y, option);
+}
+
+bool probeDomains(SupportCounter& counter, SearchStats& stats)
+{
+	if (stats.probeLimit <= 0)
+		return true;
+	int w = counter.columnCount();
+	vector<char> current, branch[2]; //decided cells now, after probing filled and after probing empty
+	decidedCells(counter, current);
+	long long probes = 0;
+	size_t unchanged = 0; //cells passed since one last settled anything, a whole round of them ends probing
+	for (size_t cell = 0; unchanged < current.size() && probes < stats.probeLimit; cell = (cell + 1) % current.size(), unchanged++)
+	{
+		if (current[cell] != 0)
+			continue;
+		probes++;
+		stats.probes++;
+		int y = cell / w, x = cell % w;
+		size_t mark = counter.mark();
+		bool consistent[2];
+		for (int value = 0; value < 2; value++)
+		{
+			fixCell(counter, y, x, value == 0);
+			consistent[value] = counter.propagate();
+			if (consistent[value])
+				decidedCells(counter, branch[value]);
+			counter.undo(mark);
+		}
+		if (!consistent[0] && !consistent[1])
+			return false;
+
+		bool fixed = false;
+		if (consistent[0] != consistent[1]) //the value that failed can never hold
+		{
+			fixCell(counter, y, x, consistent[0]);
+			fixed = true;
+		}
+		else
+			for (size_t i = 0; i < current.size(); i++)
+				if (current[i] == 0 && branch[0][i] != 0 && branch[0][i] == branch[1][i]) //either way the cell ends up the same
+				{
+					fixCell(counter, i / w, i % w, branch[0][i] == 'X');
+					fixed = true;
+				}
+		if (!fixed)
+			continue;
+		if (!counter.propagate())
+			return false;
+
+		long long before = count(current.begin(), current.end(), 0);
+		decidedCells(counter, current);
+		stats.settled += before - count(current.begin(), current.end(), 0);
+		unchanged = 0;
+	}
+	return true;
+}
+
+bool macBacktrack(SupportCounter& counter, SearchStats& stats)
+{
+	stats.nodes++;
+	stats.trailPeak = counter.trailPeak();
+	if (stats.limitReached() || !probeDomains(counter, stats))
+		return false;
+
+	bool isRow;
+	int line, splitCell;
+	if (!chooseSplit(counter, isRow, line, splitCell)) //solution found
+		return true;
+
+	//each half of the split is propagated before going deeper
+	LineDomain& domain = counter.domain(isRow, line);
+	size_t mark = counter.mark();
+	vector<uint64_t> otherHalf;
+	for (bool filled : { true, false })
+	{
+		domain.selectCell(splitCell, !filled, otherHalf);
+		for (int option = LineDomain::next(otherHalf, -1); option != -1; option = LineDomain::next(otherHalf, option))
+			counter.remove(isRow, line, option);
+
+		if (counter.propagate() && macBacktrack(counter, stats))
+			return true; //the domains are left holding the solution
+		counter.undo(mark);
+		if (stats.limitReached())
+			break;
+	}
+	counter.undo(mark);
+	return false;
+}
+
+long long macCount(SupportCounter& counter, long long limit, SearchStats& stats)
+{
+	stats.nodes++;
+	stats.trailPeak = counter.trailPeak();
+	if (stats.limitReached() || !probeDomains(counter, stats))
+		return 0;
+
+	bool isRow;
+	int line, splitCell;
+	if (!chooseSplit(counter, isRow, line, splitCell)) //every domain singular, one solution
+		return 1;
+
+	//both halves are searched unless the first already reached the limit
+	LineDomain& domain = counter.domain(isRow, line);
+	size_t mark = counter.mark();
+	vector<uint64_t> otherHalf;
+	long long found = 0;
+	for (bool filled : { true, false })
+	{
+		domain.selectCell(splitCell, !filled, otherHalf);
+		for (int option = LineDomain::next(otherHalf, -1); option != -1; option = LineDomain::next(otherHalf, option))
+			counter.remove(isRow, line, option);
+
+		if (counter.propagate())
+			found += macCount(counter, limit - found, stats);
+		counter.undo(mark);
+		if (found >= limit || stats.limitReached())
+			break;
+	}
+	return found;
+}
+
+bool domainsAreSingular(const vector<LineDomain>& rowDomain, const vector<LineDomain>& columnDomain, const vector<bool>& rowAssign, const vector<bool>& columnAssign)
+{
+	for (bool assign : rowAssign)
+		if (!assign)
+			return false;
+
+	for (bool assign : columnAssign)
+		if (!assign)
+			return false;
+
+	for (const LineDomain& rowsOptions : rowDomain)
+		if (rowsOptions.size() != 1) //if multiple or no options are left, then the nonogram was invalid
+			return false;
+	for (const LineDomain& columnsOptions : columnDomain)
+		if (columnsOptions.size() != 1) //if multiple or no options are left, then the nonogram was invalid
+			return false;
+
+	return true; //solved!
+}
+
+static bool solveWithDomains(Nonogram& n, SolveReport& report, ostream& log, Propagation mode, double lineBudget, int threads)
+{
+	log << "creating options..." << endl;
+
+	vector<bool> rowLazy, columnLazy;
+	vector<LineDomain> rowDomain = getRowOptions(n, lineBudget, rowLazy);
+	vector<LineDomain> columnDomain = getColumnOptions(n, lineBudget, columnLazy);
+	vector<vector<char>> grid(n.getWidth(), vector<char>(n.getHeight(), ' ')); //cells known so far
+
+	log << "options created... " << endl;
+	if (!boundedConsistency(n, rowDomain, columnDomain, rowLazy, columnLazy, grid, lineBudget))
+		return false; //known cells contradict
+
+	int lazyLines = 0;
+	for (bool lazy : rowLazy)
+		lazyLines += lazy;
+	for (bool lazy : columnLazy)
+		lazyLines += lazy;
+	if (lazyLines > 0) //some lines are still too big to hold, the cell search never needs their domains
+	{
+		log << lazyLines << " lines over the budget, searching cells..." << endl;
+		SearchStats stats;
+		stats.probeLimit = defaultProbeLimit;
+		bool found = lineSearch(n, grid, stats);
+		report.nodes += stats.nodes;
+		report.settled += stats.settled;
+		if (!found)
+			return false;
+		log << "Solution found" << endl;
+		for (int x = 0; x < n.getWidth(); x++)
+			for (int y = 0; y < n.getHeight(); y++)
+				n[x][y] = grid[x][y] == 'X' ? 'X' : ' ';
+		return true;
+	}
+	
+	log << "Checking arcs..." << endl;
+
+	if (!propagate(rowDomain, columnDomain, mode))
+		return false; //arcs weren't consistent
+
+	log << "Arcs verified" << endl;
+	log << "Searching..." << endl;
+
+	SearchStats stats;
+	stats.probeLimit = defaultProbeLimit;
+	auto start = chrono::steady_clock::now();
+	if (threads > 1)
+	{
+		bool found = parallelSearch(rowDomain, columnDomain, threads, stats);
+		report.nodes += stats.nodes;
+		report.settled += stats.settled;
+		if (!found)
+			return false;
+	}
+	else
+	{
+		SupportCounter counter(rowDomain, columnDomain); //the search keeps the domains consistent through the counts
+		bool found = counter.propagate() && macBacktrack(counter, stats);
+		report.nodes += stats.nodes;
+		report.settled += stats.settled;
+		if (!found)
+			return false;
+	}
+
+	log << "Solution found after " << stats.nodes << " nodes in "
+		<< chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() << " ms, probing settled "
+		<< stats.settled << " cells" << endl;
+
+	//else the nonogram must be valid
+	for (int x = 0; x < n.getWidth(); x++)
+	{
+		const LineDomain& column = columnDomain[x];
+		int option = column.first();
+		for (int y = 0; y < n.getHeight(); y++)
+			n[x][y] = column.getCell(option, y);
+	}
+	return true;
+}
+
+bool solve(Nonogram& n, SolveReport& report, ostream& log, Propagation mode, double lineBudget, int threads)
+{
+	auto start = chrono::steady_clock::now();
+	Arena arena; //the scratch of every phase, freed at once on return
+	ArenaScope scope(Arena::enabled() ? &arena : nullptr);
+	bool solved;
+	if (mode == LINE_SOLVING) //never materializes domains, so large puzzles do not stall creating options
+	{
+		log << "Solving lines..." << endl;
+		SearchStats stats;
+		stats.probeLimit = defaultProbeLimit;
+		//fixed size boards allocate nothing, they are small enough to skip probing
+		solved = hasSmallSolver(n.getWidth(), n.getHeight()) ? solveSmall(n, stats) : solveByLines(n, stats);
+		report.nodes += stats.nodes;
+		report.settled += stats.settled;
+		if (solved)
+			log << "Solution found, probing settled " << stats.settled << " cells" << endl;
+	}
+	else if (mode == SAT_SOLVING)
+	{
+		log << "Solving clauses..." << endl;
+		SearchStats stats;
+		solved = solveSat(n, stats);
+		report.nodes += stats.nodes;
+		if (solved)
+			log << "Solution found after " << stats.nodes << " decisions" << endl;
+	}
+	else if (mode == PORTFOLIO)
+	{
+		vector<PortfolioConfig> configs = defaultPortfolio(threads);
+		log << "Racing " << configs.size() << " solvers..." << endl;
+		PortfolioReport portfolio;
+		PortfolioResult result = solvePortfolio(n, configs, portfolio, 0, lineBudget);
+		solved = result == PORTFOLIO_SOLVED;
+		report.nodes += portfolio.nodes;
+		if (solved)
+			log << "Solution found by solver " << portfolio.winner << " after " << portfolio.nodes << " nodes in all" << endl;
+		else if (result == PORTFOLIO_UNSOLVABLE)
+			log << "No solution, shown by solver " << portfolio.winner << " after " << portfolio.nodes << " nodes in all" << endl;
+	}
+	else
+		solved = solveWithDomains(n, report, log, mode, lineBudget, threads);
+
+	report.arenaAllocations += arena.allocations();
+	report.arenaPeak = max(report.arenaPeak, arena.peakBytes());
+	report.arenaNanoseconds += arena.nanoseconds();
+	report.ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+	return solved;
+}
+
+bool solve(Nonogram& n, Propagation mode, double lineBudget, int threads)
+{
+	size_t baseline = currentMemory();
+	resetPeakMemory();
+
+	SolveReport report;
+	bool solved = solve(n, report, cout, mode, lineBudget, threads);
+
+	if (memoryTracked())
+		cout << "Peak memory: " << (peakMemory() - baseline) / 1024 << " KiB" << endl;
+	return solved;
+}
+long long countSolutions(const Nonogram& n, long long limit, SearchStats& stats, int threads, double lineBudget)
+{
+	Arena arena;
+	ArenaScope scope(Arena::enabled() ? &arena : nullptr);
+	vector<bool> rowLazy, columnLazy;
+	vector<LineDomain> rowDomain = getRowOptions(n, lineBudget, rowLazy);
+	vector<LineDomain> columnDomain = getColumnOptions(n, lineBudget, columnLazy);
+	vector<vector<char>> grid(n.getWidth(), vector<char>(n.getHeight(), ' '));
+	if (!boundedConsistency(n, rowDomain, columnDomain, rowLazy, columnLazy, grid, lineBudget))
+		return 0;
+
+	for (vector<bool>* lazy : { &rowLazy, &columnLazy })
+		for (bool isLazy : *lazy)
+			if (isLazy) //like solveWithDomains, lines over the budget leave the search to the cells
+				return countLineSolutions(n, grid, limit, stats);
+
+	if (threads > 1)
+		return parallelCount(rowDomain, columnDomain, threads, limit, stats);
+	SupportCounter counter(rowDomain, columnDomain);
+	return counter.propagate() ? macCount(counter, limit, stats) : 0;
+}
+
+bool isUnique(const Nonogram& n, int threads)
+{
+	SearchStats stats;
+	stats.probeLimit = defaultProbeLimit;
+	return countSolutions(n, 2, stats, threads) == 1;
+}
+//end Constraint Satisfaction Problem functions
@@ -0,0 +1,145 @@
+//the constraint satisfaction solver for a nonogram
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include "Nonogram.h"
+#include "LineDomain.h"
+#include "BoundedDomains.h"
+#include <atomic>
+#include <ostream>
+#include <random>
+#include <set>
+#include <vector>
+using std::atomic;
+using std::memory_order_relaxed;
+using std::mt19937;
+using std::ostream;
+using std::set;
+using std::vector;
+
+//setup functions
+set< vector<int> > getLineSetRecursive(int width, int sum);
+set< vector<int> > getLineSet(int width, int sum);
+
+vector<char> decodeLineSet(const vector<int>& gaps, const vector<int>& streak, int width);
+
+int getWidth(const vector<int>& streaks);
+int getSum(const vector<int>& streaks, int width, int lineWidth);
+
+vector<LineDomain> getRowOptions(const Nonogram& n);
+vector<LineDomain> getColumnOptions(const Nonogram& n);
+
+//Constraint Satisfaction Problem functions
+bool revise(int sourceIndex, int destIndex, LineDomain& sourceDomain, const LineDomain& destDomain); //restrict domain of row/column based on a different column/row (works either way)
+
+struct arcType   //a structure for a queue
+{
+	int source;
+	int destination;
+	bool sourceIsRow; //if the source element is a row/column and the destination is a column/row
+};
+
+struct PropagationStats
+{
+	long long revisions = 0; //calls to revise
+	size_t queuePeak = 0; //most arcs waiting to be revised at once
+};
+
+bool arcConsistency(vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain); //check for arc consistency and restricts domains
+//each arc waits in the queue at most once, smallest source domain first, and an arc into a revised line is queued again
+//only when the revision changed what that line forces on their shared cell
+bool arcConsistency(vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain, PropagationStats& stats);
+bool supportConsistency(vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain); //same fixpoint as arcConsistency, pruned through per cell support counts
+
+enum Propagation //how domains are made consistent before the search
+{
+	ARC_CONSISTENCY, //AC-3 over every row/column arc
+	SUPPORT_COUNTING, //per cell counts of filled candidates, see SupportCounter
+	LINE_SOLVING, //no domains at all, lines are solved from their clue and known cells, see LineSolver
+	SAT_SOLVING, //cells and clue automata as clauses for a clause learning solver, see SatSolver
+	PORTFOLIO //differently configured solvers race on the threads, the first answer wins, see Portfolio
+};
+bool propagate(vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain, Propagation mode);
+bool domainsAreSingular(const vector<LineDomain>& rowDomain, const vector<LineDomain>& columnDomain, const vector<bool>& rowAssign, const vector<bool>& columnAssign); //basically if the domain infers we have a solution
+
+struct trailType //a candidate removed during the search, put back when its branch is undone
+{
+	int line;
+	int option;
+	bool isRow;
+};
+
+const long long defaultProbeLimit = 1000; //cells solve probes per search node, about one round of a 30x30 board
+
+enum Branching //how backtrack picks what to branch on
+{
+	BRANCH_SMALLEST, //the unassigned line with the fewest candidates, columns on ties
+	BRANCH_WEIGHTED_DEGREE, //the fewest candidates per failure weight, lines that emptied recently weigh the most
+	BRANCH_CONTESTED_CELL //the cell whose line's candidates split the most evenly, lines are assigned once singular
+};
+
+struct SearchStats
+{
+	long long nodes = 0; //calls to backtrack
+	size_t trailPeak = 0; //most removals held on the trail at once
+	long long nodeLimit = 0; //give up after this many nodes, 0 for no limit
+	const atomic<bool>* stop = nullptr; //give up once another thread sets this
+	long long probeLimit = 0; //cells probed per probing pass, 0 leaves probing off
+	long long probes = 0; //cells tried both ways
+	long long settled = 0; //cells probing fixed, what propagation then fixed included
+	long long backjumps = 0; //failures that skipped past at least one decision level
+	long long jumpedLevels = 0; //decision levels skipped over by those
+	long long nogoodsLearned = 0;
+	long long nogoodHits = 0; //assignments refused by a learned nogood
+	Branching branching = BRANCH_SMALLEST; //backtrack only
+	bool supportOrder = false; //backtrack tries the values the crossing candidates agree with most first
+	mt19937* random = nullptr; //backtrack shuffles each line's candidates before ordering them, so ties break by the seed
+	vector<double> lineWeights; //BRANCH_WEIGHTED_DEGREE failures per line, rows then columns
+	double weightIncrement = 1; //what the next failure adds, grown so that recent failures count the most
+
+	bool limitReached() const { return (nodeLimit > 0 && nodes >= nodeLimit) || (stop && stop->load(memory_order_relaxed)); }
+};
+
+//true once every line is assigned, the domains are then left holding the solution
+bool backtrack(vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain, vector<bool>& rowAssign, vector<bool>& columnAssign);
+bool backtrack(vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain, vector<bool>& rowAssign, vector<bool>& columnAssign, vector<trailType>& trail, SearchStats& stats);
+bool assignBacktrack(int index, bool isRow, vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain, vector<bool>& rowAssign, vector<bool>& columnAssign, vector<trailType>& trail, SearchStats& stats);
+void undoTrail(vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain, vector<trailType>& trail, size_t mark); //restore removals past mark
+
+class SupportCounter;
+//pick the smallest undecided domain and its most evenly divided cell, false if every domain is singular
+bool chooseSplit(const SupportCounter& counter, bool& isRow, int& line, int& cell);
+//maintains support counting consistency after every assignment. the smallest undecided domain is split on its most even cell,
+//the counter must already be consistent, true once every domain is singular and the domains hold the solution
+bool macBacktrack(SupportCounter& counter, SearchStats& stats);
+//the same search through every branch, solutions found below the counter's state up to limit. the counter is left as it was
+long long macCount(SupportCounter& counter, long long limit, SearchStats& stats);
+//tries both values of each undecided cell with propagation, up to stats.probeLimit cells a pass. a value that empties a
+//domain fixes the other and cells both values decide alike are fixed, passes repeat while they settle cells. removals go
+//through the counter, so the caller's undo takes them back. false when both values of a cell fail
+bool probeDomains(SupportCounter& counter, SearchStats& stats);
+
+struct SolveReport //what one solve cost
+{
+	long long nodes = 0; //search nodes, guessed cells when solving lines
+	long long settled = 0; //cells fixed by probing
+	double ms = 0; //the whole solve, building domains included
+	size_t arenaAllocations = 0; //handed out by the solve's arena, 0 while arenas are off
+	size_t arenaPeak = 0; //most bytes the arena held at once
+	long long arenaNanoseconds = 0; //spent allocating from the arena, measured only while allocation timing is on
+};
+
+//domain modes materialize at most lineBudget candidates per line and search on threads workers, PORTFOLIO races that
+//many solvers. progress goes to log.
+//safe to run on several threads at once, each with its own nonogram. the scratch of a solve comes from an arena of its
+//own thread that is freed in one go when it returns
+bool solve(Nonogram& n, SolveReport& report, ostream& log, Propagation mode = LINE_SOLVING, double lineBudget = defaultLineBudget, int threads = 1);
+//the same with progress on cout, also prints the peak heap use of the solve in builds that track memory
+bool solve(Nonogram& n, Propagation mode = LINE_SOLVING, double lineBudget = defaultLineBudget, int threads = 1);
+
+//solutions of the labels of n up to limit, through bounded domains and support counting like solve. the grid of n is
+//ignored. once stats.limitReached() the count only says that many solutions exist
+long long countSolutions(const Nonogram& n, long long limit, SearchStats& stats, int threads = 1, double lineBudget = defaultLineBudget);
+bool isUnique(const Nonogram& n, int threads = 1); //exactly one solution, searching only until a second one shows up
+
+#endif
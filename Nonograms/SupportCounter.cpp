@@ -0,0 +1,144 @@
+#include "SupportCounter.h"
+using namespace std;
+
+//call visit(cell) for every filled cell of a packed candidate
+template <typename Visit>
+static void forEachFilled(const LineDomain& domain, int option, Visit visit)
+{
+	const uint64_t* line = domain.getLine(option);
+	int words = (domain.length() + 63) / 64;
+	for (int w = 0; w < words; w++)
+		for (uint64_t word = line[w]; word != 0; word &= word - 1) //clear the lowest bit each step
+			visit(w * 64 + countTrailingZeros(word));
+}
+
+SupportCounter::SupportCounter(vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain) : rows(rowDomain), columns(columnDomain)
+{
+	rowFilled.resize(rows.size());
+	rowQueued.resize(rows.size());
+	for (int row = 0; row < rows.size(); row++)
+	{
+		rowFilled[row].assign(rows[row].length(), 0);
+		rowQueued[row].assign(rows[row].length(), 0);
+		for (int option = rows[row].first(); option != -1; option = rows[row].next(option))
+			forEachFilled(rows[row], option, [&](int cell) { rowFilled[row][cell]++; });
+	}
+
+	columnFilled.resize(columns.size());
+	columnQueued.resize(columns.size());
+	for (int column = 0; column < columns.size(); column++)
+	{
+		columnFilled[column].assign(columns[column].length(), 0);
+		columnQueued[column].assign(columns[column].length(), 0);
+		for (int option = columns[column].first(); option != -1; option = columns[column].next(option))
+			forEachFilled(columns[column], option, [&](int cell) { columnFilled[column][cell]++; });
+	}
+}
+
+void SupportCounter::remove(bool isRow, int line, int option)
+{
+	vector<int>& filled = (isRow ? rowFilled : columnFilled)[line];
+	forEachFilled(domain(isRow, line), option, [&](int cell) { filled[cell]--; });
+	domain(isRow, line).remove(option);
+	trail.push_back(trailType{ line, option, isRow });
+	if (trail.size() > trailHigh)
+		trailHigh = trail.size();
+}
+
+void SupportCounter::restoreCandidate(bool isRow, int line, int option)
+{
+	vector<int>& filled = (isRow ? rowFilled : columnFilled)[line];
+	forEachFilled(domain(isRow, line), option, [&](int cell) { filled[cell]++; });
+	domain(isRow, line).restore(option);
+
+	//a cell that has both values again is no longer fixed, it must be queued anew if it gets fixed later
+	vector<char>& queued = (isRow ? rowQueued : columnQueued)[line];
+	for (int cell = 0; cell < queued.size(); cell++)
+		if (queued[cell])
+		{
+			if (filledCount(isRow, line, cell) > 0)
+				queued[cell] &= ~1;
+			if (emptyCount(isRow, line, cell) > 0)
+				queued[cell] &= ~2;
+		}
+}
+
+void SupportCounter::undo(size_t mark)
+{
+	while (trail.size() > mark)
+	{
+		trailType removed = trail.back();
+		trail.pop_back();
+		restoreCandidate(removed.isRow, removed.line, removed.option);
+	}
+}
+
+void SupportCounter::queueFixedCells(bool isRow, int line)
+{
+	vector<char>& queued = (isRow ? rowQueued : columnQueued)[line];
+	for (int cell = 0; cell < queued.size(); cell++)
+	{
+		bool neverFilled = filledCount(isRow, line, cell) == 0;
+		bool alwaysFilled = emptyCount(isRow, line, cell) == 0;
+		if ((neverFilled && !(queued[cell] & 1)) || (alwaysFilled && !(queued[cell] & 2)))
+		{
+			queued[cell] |= (neverFilled ? 1 : 0) | (alwaysFilled ? 2 : 0);
+			toPrune.push_back(cellType{ line, cell, isRow });
+		}
+	}
+}
+
+bool SupportCounter::pruneCrossing(const cellType& fixed)
+{
+	bool crossIsRow = !fixed.isRow;
+	int crossLine = fixed.cell; //the line crossing the fixed cell
+	int crossCell = fixed.line; //where the fixed cell sits in that line
+	bool filledSupported = filledCount(fixed.isRow, fixed.line, fixed.cell) > 0;
+	bool emptySupported = emptyCount(fixed.isRow, fixed.line, fixed.cell) > 0;
+
+	LineDomain& cross = domain(crossIsRow, crossLine);
+	bool isRevised = false;
+	for (bool filled : { true, false })
+		if (!(filled ? filledSupported : emptySupported))
+		{
+			static thread_local vector<uint64_t> unsupported;
+			cross.selectCell(crossCell, filled, unsupported);
+			for (int option = LineDomain::next(unsupported, -1); option != -1; option = LineDomain::next(unsupported, option))
+			{
+				remove(crossIsRow, crossLine, option);
+				isRevised = true;
+			}
+		}
+
+	if (cross.empty())
+		return false;
+	if (isRevised)
+		queueFixedCells(crossIsRow, crossLine);
+	return true;
+}
+
+bool SupportCounter::propagate()
+{
+	toPrune.clear();
+	for (int row = 0; row < rows.size(); row++)
+	{
+		if (rows[row].empty())
+			return false;
+		queueFixedCells(true, row);
+	}
+	for (int column = 0; column < columns.size(); column++)
+	{
+		if (columns[column].empty())
+			return false;
+		queueFixedCells(false, column);
+	}
+
+	while (!toPrune.empty()) //each cell and value is queued at most once, so the order does not matter
+	{
+		cellType fixed = toPrune.back();
+		toPrune.pop_back();
+		if (!pruneCrossing(fixed))
+			return false;
+	}
+	return true;
+}
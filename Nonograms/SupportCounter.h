@@ -0,0 +1,54 @@
+//propagation by counting, for every cell of every line, how many live candidates fill it
+#ifndef SUPPORTCOUNTER_H
+#define SUPPORTCOUNTER_H
+
+#include "LineDomain.h"
+#include "Solver.h"
+#include <vector>
+using std::vector;
+
+class SupportCounter
+{
+	public:
+		SupportCounter(vector<LineDomain>& rowDomain, vector<LineDomain>& columnDomain); //counts the live candidates of every line
+
+		//remove every candidate whose value at a crossing no live candidate of the crossing line shares, false if a domain empties
+		bool propagate();
+
+		//removals are recorded on the trail so a search can undo them, counts included
+		void remove(bool isRow, int line, int option);
+		size_t mark() const { return trail.size(); }
+		void undo(size_t mark); //restore every removal made since mark
+		size_t trailPeak() const { return trailHigh; }
+
+		LineDomain& domain(bool isRow, int line) { return isRow ? rows[line] : columns[line]; }
+		const LineDomain& domain(bool isRow, int line) const { return isRow ? rows[line] : columns[line]; }
+		int rowCount() const { return rows.size(); }
+		int columnCount() const { return columns.size(); }
+
+		int filledCount(bool isRow, int line, int cell) const { return (isRow ? rowFilled : columnFilled)[line][cell]; }
+		int emptyCount(bool isRow, int line, int cell) const { return domain(isRow, line).size() - filledCount(isRow, line, cell); }
+	private:
+		struct cellType //a cell of a line whose crossing line must be pruned against it
+		{
+			int line;
+			int cell;
+			bool isRow;
+		};
+
+		void restoreCandidate(bool isRow, int line, int option); //put back and count its cells again
+		void queueFixedCells(bool isRow, int line); //queue the cells of a line that just lost all filled or all empty candidates
+		bool pruneCrossing(const cellType& fixed); //prune the line crossing a fixed cell, false if it empties
+
+		vector<LineDomain>& rows;
+		vector<LineDomain>& columns;
+		vector<vector<int>> rowFilled; //rowFilled[row][column] live row candidates filling that cell
+		vector<vector<int>> columnFilled; //columnFilled[column][row]
+		vector<vector<char>> rowQueued; //bit 1 once a cell was queued as never filled, bit 2 as always filled
+		vector<vector<char>> columnQueued;
+		vector<cellType> toPrune;
+		vector<trailType> trail;
+		size_t trailHigh = 0;
+};
+
+#endif
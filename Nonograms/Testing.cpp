@@ -1,379 +1,50 @@
 ﻿#include "Nonogram.h"
+#include "Solver.h"
+#include "Benchmark.h"
+#include "ThreadPool.h"
+#include "Batch.h"
+#include "SatSolver.h"
+#include "MemoryTracker.h"
 #include <iostream>
 #include <fstream>
-#include <queue>
-#include <set>
-#include <map>
 #include <chrono>
 #include <random>
 #include <string>
 using namespace std;
 using chrono::high_resolution_clock;
 
-//funcion headers
-//setup functions
-set< vector<int> > getLineSetRecursive(int width, int sum);
-set< vector<int> > getLineSet(int width, int sum);
-
-vector<char> decodeLineSet(vector<int> gaps, vector<int> streak, int width);
-
-int getWidth(vector<int> streaks);
-int getSum(vector<int> streaks, int width, int lineWidth);
-
-vector<set<vector<char>>> getRowOptions(const Nonogram& n);
-vector<set<vector<char>>> getColumnOptions(const Nonogram& n);
-
-//Constraint Satisfaction Problem functions
-bool revise(int sourceIndex, int destIndex, set<vector<char>>& sourceDomain, const set<vector<char>>& destDomain); //restrict domain of row/column based on a different column/row (works either way)
-
-struct arcType   //a structure for a queue
+int main(int argc, char* argv[])
 {
-	int source;
-	int destination;
-	bool sourceIsRow; //if the source element is a row/column and the destination is a column/row
-};
-
-bool arcConsistency(vector<set<vector<char>>>& rowDomain, vector<set<vector<char>>>& columnDomain); //check for arc consistency and restricts domains
-bool domainsAreSingular(vector<set<vector<char>>>& rowDomain, vector<set<vector<char>>>& columnDomain, vector<bool>& rowAssign, vector<bool>& columnAssign); //basically if the domain infers we have a solution
-
-void backtrack(vector<set<vector<char>>>& rowDomain, vector<set<vector<char>>>& columnDomain, vector<bool>& rowAssign, vector<bool>& columnAssign);
-void assignRowBacktrack(int rowIndex, vector<set<vector<char>>>& rowDomain, vector<set<vector<char>>>& columnDomain, vector<bool>& rowAssign, vector<bool>& columnAssign);
-void assignColumnBacktrack(int columnIndex, vector<set<vector<char>>>& rowDomain, vector<set<vector<char>>>& columnDomain, vector<bool>& rowAssign, vector<bool>& columnAssign);
-
-bool solve(Nonogram& n);
-//end function headers
-
-
-
-
-//setup functions
-set< vector<int> > getLineSet(int width, int sum)
-{
-	set<vector<int>> options = getLineSetRecursive(width, sum); //basic sets
-	set<vector<int>> formattedSet; //the non first last elmements in each vector be added by one
-	for (vector<int> option : options)
+	if (argc > 1) //Nonograms batch ... solves puzzles without the menu, Nonograms suite writes the benchmark csv
 	{
-		for (int i = 1; i < option.size() - 1; i++) //every element but the 0th and last
-			++option[i];
-		formattedSet.insert(option);
-	}
-	return formattedSet;
-}
-set< vector<int> > getLineSetRecursive(int width, int sum)
-{
-	set<vector<int>> options;
-	if (width == 1) //end case
-	{
-		options.insert( { sum } );
-		return options;
-	}
-
-	for (int i = 0; i <= sum; i++) //recursive
-	{
-		set<vector<int>> subSet = getLineSetRecursive(width-1, sum-i);
-		for (vector<int> subOption : subSet)
+		string command = argv[1];
+		if (command == "batch")
+			return batchMain(argc - 2, argv + 2);
+		if (command == "suite")
 		{
-			vector<int> option = { i };
-			option.reserve(1 + subOption.size()); // preallocate memory
-			option.insert(option.end(), subOption.begin(), subOption.end()); //add sub vector to the end of the vector
-			options.insert(option);
+			benchmarkSuite(cout);
+			return 0;
 		}
-	}
-	return options;
-}
-
-vector<char> decodeLineSet(vector<int> gaps, vector<int> streak, int width)
-{
-	vector<char> line(width, ' '); //empty line
-	int i = 0;
-	int streakIndex = 0;
-	int gapIndex = 0;
-	while(gapIndex < gaps.size() && streakIndex < streak.size() && i < width)
-	{
-		i = i + gaps[gapIndex]; //skip the gap
-
-		int startStreakIndex = i;
-		for (; i < startStreakIndex + streak[streakIndex]; i++) //fill in the streak
-			line[i] = 'X';
-
-		streakIndex++; //move to the next streak
-		gapIndex++; //move to the next gap
-	}
-
-	return line;
-}
-
-int getWidth(vector<int> streaks)
-{
-	return streaks.size() + 1;
-}
-int getSum(vector<int> streaks, int width, int lineWidth)
-{
-	int streakSum = 0;
-	for (int streak : streaks)
-		streakSum = streakSum + streak;
-
-	if (width > 2)
-		return lineWidth - streakSum - (width - 2);
-	else //width is 1
-		return lineWidth - streakSum;
-}
-
-vector<set<vector<char>>> getRowOptions(const Nonogram& n)
-{
-	vector<set<vector<char>>> options(n.getHeight()); //size
-	for (int row = 0; row < n.getHeight(); row++)
-	{
-		set< vector<char> > rowOptions;
-		int width = getWidth(n.getRow(row));
-		int sum = getSum(n.getRow(row), width, n.getWidth());
-		for (vector<int> optionGaps : getLineSet(width, sum))
-			rowOptions.insert( decodeLineSet(optionGaps, n.getRow(row), n.getWidth()) ); //insert the key and value (gap vector, row char vector) into the map
-
-		options[row] = rowOptions;
-	}
-	return options;
-}
-vector<set<vector<char>>> getColumnOptions(const Nonogram& n)
-{
-	vector<set<vector<char>>> options(n.getWidth()); //size
-	for (int column = 0; column < n.getWidth(); column++)
-	{
-		set< vector<char> > columnOptions;
-		int width = getWidth(n.getColumn(column));
-		int sum = getSum(n.getColumn(column), width, n.getHeight());
-		for (vector<int> optionGaps : getLineSet(width, sum))
-			columnOptions.insert( decodeLineSet(optionGaps, n.getColumn(column), n.getHeight()) ); //insert the key and value (gap vector, row char vector) into the map
-
-		options[column] = columnOptions;
-	}
-	return options;
-}
-//end setup functions
-
-
-//Constraint Satisfaction Problem functions
-bool revise(int sourceIndex, int destIndex, set<vector<char>>& sourceDomain, const set<vector<char>>& destDomain)
-{
-	bool isRevised = false;
-	for (auto iter = sourceDomain.begin(); iter != sourceDomain.end();)
-	{
-		vector<char> sourceOption = *iter; //the option from the iterator
-		bool optionIsRevised = true; //assume revision for option until disproven
-		for (vector<char> destOption : destDomain)
-			if (sourceOption[destIndex] == destOption[sourceIndex]) //if match then option is possible
+		if (command == "cnf" && argc <= 3) //Nonograms cnf [puzzle] writes the clauses of solveSat as DIMACS for other solvers
+		{
+			Nonogram puzzle(vector<vector<int>>{}, vector<vector<int>>{}); //no labels, readPuzzle replaces it
+			ifstream file;
+			if (argc == 3)
+				file.open(argv[2]);
+			if (readPuzzle(argc == 3 ? file : cin, puzzle) != PUZZLE_READ)
 			{
-				optionIsRevised = false;
-				break;
+				cerr << "not a valid puzzle" << endl;
+				return 1;
 			}
-		if (optionIsRevised)
-		{
-			iter = sourceDomain.erase(iter); //delete this option by iterator, make sure iter value stays consistent
-			isRevised = true;
-		}
-		else
-			++iter; //if we don't remove an element we can move the iterator forward
-	}
-	return isRevised;
-}
-
-bool arcConsistency(vector<set<vector<char>>>& rowDomain, vector<set<vector<char>>>& columnDomain)
-{
-	queue<arcType> toRevise; //list of things to revise
-	for(int rowI = 0; rowI < rowDomain.size(); rowI++) //put all possible row column options to initially revise
-		for (int colI = 0; colI < columnDomain.size(); colI++)
-		{
-			//put both types of revision on the queue
-			toRevise.push( arcType{rowI, colI, true} );
-			toRevise.push( arcType{colI, rowI, false} );
-		}
-
-	while (!toRevise.empty()) //while revisions are still necessary
-	{
-		arcType arcRevise = toRevise.front();
-		toRevise.pop(); //remove elmeent
-
-		bool revised; //if a revision happened
-		if (arcRevise.sourceIsRow)
-			revised = revise(arcRevise.source, arcRevise.destination, rowDomain[arcRevise.source], columnDomain[arcRevise.destination]);
-		else //source is a column
-			revised = revise(arcRevise.source, arcRevise.destination, columnDomain[arcRevise.source], rowDomain[arcRevise.destination]);
-
-		if (revised)
-		{
-			//if the new domain of the source is null, then we have an inconsistent nonogram
-			if (arcRevise.sourceIsRow && rowDomain[arcRevise.source].empty())
-				return false;
-			else if (!arcRevise.sourceIsRow && columnDomain[arcRevise.source].empty()) //arcRevise source is a columnIndex
-				return false;
-
-			//since the domain of source is now smaller we have to revise all the domains it affects
-			if (arcRevise.sourceIsRow)
-				for (int colI = 0; colI < columnDomain.size(); colI++)
-					toRevise.push( arcType{ colI, arcRevise.source, false } );
-			else //source is a column
-				for (int rowI = 0; rowI < rowDomain.size(); rowI++)
-					toRevise.push( arcType{ rowI, arcRevise.source, true } );
-		}
-	}
-	return true; //consistent
-}
-
-void backtrack(vector<set<vector<char>>>& rowDomain, vector<set<vector<char>>>& columnDomain, vector<bool>& rowAssign, vector<bool>& columnAssign)
-{
-	if (domainsAreSingular(rowDomain, columnDomain, rowAssign, columnAssign)) //solution found
-		return;
-
-	int smallestRowIndex = 0;
-	int smallestRowSize = INT_MAX;
-	for (int i = 0; i < rowDomain.size(); i++)
-		if (!rowAssign[i] && rowDomain[i].size() < smallestRowSize)
-		{
-			smallestRowIndex = i;
-			smallestRowSize = rowDomain[i].size();
-		}
-	
-	int smallestColumnIndex = 0;
-	int smallestColumnSize = INT_MAX;
-	for (int i = 0; i < columnDomain.size(); i++)
-		if (!columnAssign[i] && columnDomain[i].size() < smallestColumnSize)
-		{
-			smallestColumnIndex = i;
-			smallestColumnSize = columnDomain[i].size();
-		}
-	
-	if (smallestRowSize < smallestColumnSize)
-		return assignRowBacktrack(smallestRowIndex, rowDomain, columnDomain, rowAssign, columnAssign); //row is assigned
-	else //smallestColumnSize <= smallestRowSize
-		return assignColumnBacktrack(smallestColumnIndex, rowDomain, columnDomain, rowAssign, columnAssign); //inverted order, so column is assigned
-}
-
-void assignRowBacktrack(int rowIndex, vector<set<vector<char>>>& rowDomain, vector<set<vector<char>>>& columnDomain, vector<bool>& rowAssign, vector<bool>& columnAssign)
-{
-	rowAssign[rowIndex] = true;
-	for (auto iter = rowDomain[rowIndex].begin(); iter != rowDomain[rowIndex].end(); ++iter)
-	{
-		vector<char> assign = *iter;
-
-		set<vector<char>> oldRowDomain = rowDomain[rowIndex];
-		rowDomain[rowIndex] = { assign }; //new domain for tihs row is just the assignment
-		
-		vector<set<vector<char>>> newColumnsDomain = columnDomain;
-		//take away newly restriced domain values
-		for (int i = 0; i < newColumnsDomain.size(); i++) //go through each column set
-			revise(i, rowIndex, newColumnsDomain[i], rowDomain[rowIndex]);
-
-
-		backtrack(rowDomain, newColumnsDomain, rowAssign, columnAssign); //continue seraching
-		
-		if (domainsAreSingular(rowDomain, newColumnsDomain, rowAssign, columnAssign))
-		{
-			columnDomain = newColumnsDomain; //set the newColumn domain
-			return; //valid solution
-		}
-
-		//revert assignment
-		rowDomain[rowIndex] = oldRowDomain;
-		iter = rowDomain[rowIndex].find(assign);
-	}
-	rowAssign[rowIndex] = false;
-	return; //failure
-}
-void assignColumnBacktrack(int columnIndex, vector<set<vector<char>>>& rowDomain, vector<set<vector<char>>>& columnDomain, vector<bool>& rowAssign, vector<bool>& columnAssign)
-{
-	columnAssign[columnIndex] = true;
-	for (auto iter = columnDomain[columnIndex].begin(); iter != columnDomain[columnIndex].end(); ++iter)
-	{
-		vector<char> assign = *iter;
-
-		set<vector<char>> oldColumnDomain = columnDomain[columnIndex];
-		columnDomain[columnIndex] = { assign }; //new domain for tihs row is just the assignment
-		
-		vector<set<vector<char>>> newRowsDomain = rowDomain;
-		//take away newly restriced domain values
-		for (int i = 0; i < newRowsDomain.size(); i++) //go through each row set
-			revise(i, columnIndex, newRowsDomain[i], columnDomain[columnIndex]);
-
-		backtrack(newRowsDomain, columnDomain, rowAssign, columnAssign); //continue seraching
-
-		if (domainsAreSingular(newRowsDomain, columnDomain, rowAssign, columnAssign))
-		{
-			rowDomain = newRowsDomain; //set the newColumn domain
-			return; //valid solution
+			cout << "c " << puzzle.getWidth() << 'x' << puzzle.getHeight() << " nonogram, cell (x, y) is variable y * "
+				<< puzzle.getWidth() << " + x + 1, true when filled" << '\n';
+			writeDimacs(cout, encodeNonogram(puzzle));
+			return 0;
 		}
-
-		//revert assignment
-		columnDomain[columnIndex] = oldColumnDomain;
-		iter = columnDomain[columnIndex].find(assign);
+		cerr << "usage: Nonograms [batch ... | suite | cnf [puzzle]]" << endl;
+		return 2;
 	}
-	columnAssign[columnIndex] = false;
-	return; //failure
-}
-
-bool domainsAreSingular(vector<set<vector<char>>>& rowDomain, vector<set<vector<char>>>& columnDomain, vector<bool>& rowAssign, vector<bool>& columnAssign)
-{
-	for (bool assign : rowAssign)
-		if (!assign)
-			return false;
-
-	for (bool assign : columnAssign)
-		if (!assign)
-			return false;
-
-	for (set<vector<char>> rowsOptions : rowDomain)
-		if (rowsOptions.size() > 1 || rowsOptions.empty()) //if multiple or no options are left, then the nonogram was invalid
-			return false;
-	for (set<vector<char>> columnsOptions : columnDomain)
-		if (columnsOptions.size() > 1 || columnsOptions.empty()) //if multiple or no options are left, then the nonogram was invalid
-			return false;
-
-	return true; //solved!
-}
-
-bool solve(Nonogram& n)
-{
-	cout << "creating options..." << endl;
-
-	vector<set<vector<char>>> rowDomain = getRowOptions(n);
-	vector<set<vector<char>>> columnDomain = getColumnOptions(n);
-	
-	vector<bool> rowAssign(n.getHeight(), false);
-	vector<bool> columnAssign(n.getWidth(), false);
-
-	cout << "options created... " << endl;
-	cout << "Checking arcs..." << endl;
-
-	if (!arcConsistency(rowDomain, columnDomain))
-		return false; //arcs weren't consistent
-
-	cout << "Arcs verified" << endl;
-	cout << "Searching..." << endl;
-
-	backtrack(rowDomain, columnDomain, rowAssign, columnAssign);
-
-	if (!domainsAreSingular(rowDomain, columnDomain, rowAssign, columnAssign))
-		return 0;
-
-	cout << "Solution found" << endl;
-
-	//else the nonogram must be valid
-	for (int x = 0; x < n.getWidth(); x++)
-	{
-		vector<char> column = *columnDomain[x].begin();
-		for (int y = 0; y < n.getHeight(); y++)
-			n[x][y] = column[y];
-	}
-	return true;
-
-}
-//end Constraint Satisfaction Problem functions
-
-
-
 
-
-int main()
-{
 	int width = 5;
 	int height = 5;
 	string input = "";
@@ -390,7 +61,33 @@ int main()
 		cout << "m, modify: modify the width and height of the nonogram" << endl;
 		cout << "p, show, print, display: display nonogram in its current state" << endl << endl;
 		cout << "s, solve: solve nonogram" << endl;
+		cout << "ps, parallel: solve nonogram with domains on every hardware thread" << endl;
+		cout << "pf, portfolio: solve nonogram by racing differently configured solvers on every hardware thread" << endl;
+		cout << "u, unique: count the solutions of the nonogram's labels, up to 100" << endl;
 		cout << "c, clear: clear nonogram cells" << endl;
+		if (!memoryTracked())
+			cout << "(heap use and allocation counts in the benchmarks need a build with NONOGRAMS_TRACK_MEMORY)" << endl;
+		cout << "b, bench: compare solver domains on random puzzles" << endl;
+		cout << "prop, propagation: compare arc consistency and support counting on random puzzles" << endl;
+		cout << "lines: compare domain solving and line solving on random puzzles" << endl;
+		cout << "search: compare copying and trail backtracking on random puzzles" << endl;
+		cout << "mac: compare forward checking and maintained consistency on random puzzles" << endl;
+		cout << "threads: compare sequential and parallel search on random puzzles" << endl;
+		cout << "suite: time every solve phase over seeded puzzle corpora as csv" << endl;
+		cout << "gen: measure how fast seeded random puzzles are generated" << endl;
+		cout << "setup: count heap allocations of building a puzzle and its domains" << endl;
+		cout << "verify: time checking a solution after one move and from scratch" << endl;
+		cout << "cache: compare line solving with and without the line cache" << endl;
+		cout << "place: compare recursive line sets and the placement iterator" << endl;
+		cout << "kernel: compare scalar and avx2 cell selection throughput" << endl;
+		cout << "small: compare line solving and the fixed size solver on 5x5, 10x10 and 15x15 puzzles" << endl;
+		cout << "uniq: check random puzzles for unique solutions on one and every hardware thread" << endl;
+		cout << "probe: compare search with and without probing on random puzzles" << endl;
+		cout << "branch: compare branching strategies and value orders of forward checking on random puzzles" << endl;
+		cout << "race: compare each portfolio solver alone and all of them racing on random puzzles" << endl;
+		cout << "sat: compare line solving and the clause learning solver on random puzzles" << endl;
+		cout << "jump: compare chronological backtracking and backjumping with nogoods on random puzzles" << endl;
+		cout << "arena: compare solves with and without the per solve arena, allocations and allocator time" << endl;
 		cout << "Current nonogram setting: width: " << width << " height: " << height << endl;
 
 		cout << ">>> ";
@@ -447,59 +144,21 @@ int main()
 				if (seg != "") //empty seg
 					column.push_back(stoi(seg));
 			}
-			n = Nonogram(rows, columns); //create from lables
+			n = Nonogram(move(rows), move(columns)); //create from lables
 		}
 		else if (input == "file")
 		{
-			ifstream file;
-			string seg;
-			file.open("puzzle.txt");
-			string line;
-
-			getline(file, line);
-			height = stoi(line);
-			vector<vector<int>> rows(height);
-			for (int i = 0; i < height; i++) //get the rows
+			ifstream file("puzzle.txt");
+			if (readPuzzle(file, n) == PUZZLE_READ) //create the nonogram from labels
 			{
-				seg = "";
-				getline(file, line);
-				for (char c : line)
-				{
-					if (isdigit(c))
-						seg = seg + c;
-					else //whitespace or something else
-					{
-						rows[i].push_back(stoi(seg));
-						seg = ""; //reset
-					}
-				}
-				if (seg != "")
-					rows[i].push_back(stoi(seg));
+				width = n.getWidth();
+				height = n.getHeight();
 			}
-
-			getline(file, line); //empty line
-
-			getline(file, line);
-			width = stoi(line);
-			vector<vector<int>> columns(width);
-			for (int i = 0; i < width; i++) //get the columns
+			else
 			{
-				seg = "";
-				getline(file, line);
-				for (char c : line)
-				{
-					if (isdigit(c))
-						seg = seg + c;
-					else //whitespace or something else
-					{
-						columns[i].push_back(stoi(seg));
-						seg = ""; //reset
-					}
-				}
-				if (seg != "")
-					columns[i].push_back(stoi(seg));
+				cout << "puzzle.txt is not a valid puzzle" << endl;
+				system("pause");
 			}
-			n = Nonogram(rows, columns); //create the nonogram from labels
 		}
 		else if (input == "m" || input == "modify")
 		{
@@ -524,8 +183,148 @@ int main()
 				cout << "could not solve!" << endl;
 			system("pause");
 		}
+		else if (input == "parallel" || input == "ps")
+		{
+			if (solve(n, SUPPORT_COUNTING, defaultLineBudget, ThreadPool::defaultThreads()))
+			{
+				system("cls");
+				cout << "Solved: " << endl;
+				cout << n;
+			}
+			else
+				cout << "could not solve!" << endl;
+			system("pause");
+		}
+		else if (input == "portfolio" || input == "pf")
+		{
+			if (solve(n, PORTFOLIO, defaultLineBudget, ThreadPool::defaultThreads()))
+			{
+				system("cls");
+				cout << "Solved: " << endl;
+				cout << n;
+			}
+			else
+				cout << "could not solve!" << endl;
+			system("pause");
+		}
+		else if (input == "unique" || input == "u")
+		{
+			SearchStats stats;
+			stats.probeLimit = defaultProbeLimit;
+			long long count = countSolutions(n, 100, stats, ThreadPool::defaultThreads());
+			if (count == 1)
+				cout << "unique solution" << endl;
+			else
+				cout << count << (count == 100 ? " or more" : "") << " solutions" << endl;
+			system("pause");
+		}
 		else if (input == "clear" || input == "c")
 			n.clearGrid();
+		else if (input == "bench" || input == "b")
+		{
+			benchmarkDomains(cout);
+			system("pause");
+		}
+		else if (input == "prop" || input == "propagation")
+		{
+			benchmarkPropagation(cout);
+			system("pause");
+		}
+		else if (input == "lines")
+		{
+			benchmarkLineSolver(cout);
+			system("pause");
+		}
+		else if (input == "search")
+		{
+			benchmarkSearch(cout);
+			system("pause");
+		}
+		else if (input == "mac")
+		{
+			benchmarkMac(cout);
+			system("pause");
+		}
+		else if (input == "threads")
+		{
+			benchmarkParallel(cout);
+			system("pause");
+		}
+		else if (input == "suite")
+		{
+			benchmarkSuite(cout);
+			system("pause");
+		}
+		else if (input == "gen")
+		{
+			benchmarkGenerator(cout);
+			system("pause");
+		}
+		else if (input == "setup")
+		{
+			benchmarkSetup(cout);
+			system("pause");
+		}
+		else if (input == "verify")
+		{
+			benchmarkVerify(cout);
+			system("pause");
+		}
+		else if (input == "cache")
+		{
+			benchmarkLineCache(cout);
+			system("pause");
+		}
+		else if (input == "place")
+		{
+			benchmarkPlacements(cout);
+			system("pause");
+		}
+		else if (input == "kernel")
+		{
+			benchmarkCellKernel(cout);
+			system("pause");
+		}
+		else if (input == "small")
+		{
+			benchmarkSmallBoards(cout);
+			system("pause");
+		}
+		else if (input == "uniq")
+		{
+			benchmarkUniqueness(cout);
+			system("pause");
+		}
+		else if (input == "probe")
+		{
+			benchmarkProbing(cout);
+			system("pause");
+		}
+		else if (input == "jump")
+		{
+			benchmarkBackjump(cout);
+			system("pause");
+		}
+		else if (input == "branch")
+		{
+			benchmarkBranching(cout);
+			system("pause");
+		}
+		else if (input == "race")
+		{
+			benchmarkPortfolio(cout);
+			system("pause");
+		}
+		else if (input == "sat")
+		{
+			benchmarkSat(cout);
+			system("pause");
+		}
+		else if (input == "arena")
+		{
+			benchmarkArena(cout);
+			system("pause");
+		}
 	}
 	return 0;
 }
@@ -0,0 +1,105 @@
+#include "ThreadPool.h"
+using namespace std;
+
+static thread_local ThreadPool* currentPool = nullptr; //the pool the calling thread works for
+static thread_local int currentWorker = -1;
+
+ThreadPool::ThreadPool(int threadCount) : queued(0), pending(0), nextWorker(0)
+{
+	if (threadCount < 1)
+		threadCount = 1;
+	for (int i = 0; i < threadCount; i++)
+		workers.push_back(make_unique<Worker>());
+	for (int i = 0; i < threadCount; i++)
+		threads.emplace_back(&ThreadPool::run, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+	wait();
+	{
+		lock_guard<mutex> guard(idleLock);
+		stopping = true;
+	}
+	idle.notify_all();
+	for (thread& worker : threads)
+		worker.join();
+}
+
+int ThreadPool::defaultThreads()
+{
+	unsigned threads = thread::hardware_concurrency();
+	return threads == 0 ? 1 : (int)threads;
+}
+
+void ThreadPool::submit(function<void()> task)
+{
+	int target = currentPool == this ? currentWorker : (int)(nextWorker++ % workers.size());
+	pending++;
+	{
+		lock_guard<mutex> guard(workers[target]->lock);
+		workers[target]->tasks.push_back(move(task));
+	}
+	queued++;
+	lock_guard<mutex> guard(idleLock); //a worker checking for work holds this, so the wake up cannot be missed
+	idle.notify_one();
+}
+
+void ThreadPool::wait()
+{
+	unique_lock<mutex> guard(idleLock);
+	finished.wait(guard, [&] { return pending == 0; });
+}
+
+bool ThreadPool::take(int self, function<void()>& task)
+{
+	{
+		lock_guard<mutex> guard(workers[self]->lock);
+		if (!workers[self]->tasks.empty())
+		{
+			task = move(workers[self]->tasks.back());
+			workers[self]->tasks.pop_back();
+			queued--;
+			return true;
+		}
+	}
+	for (int i = 1; i < workers.size(); i++) //steal the oldest, usually largest, task of the next busy worker
+	{
+		Worker& victim = *workers[(self + i) % workers.size()];
+		lock_guard<mutex> guard(victim.lock);
+		if (!victim.tasks.empty())
+		{
+			task = move(victim.tasks.front());
+			victim.tasks.pop_front();
+			queued--;
+			return true;
+		}
+	}
+	return false;
+}
+
+void ThreadPool::run(int self)
+{
+	currentPool = this;
+	currentWorker = self;
+	while (true)
+	{
+		function<void()> task;
+		if (take(self, task))
+		{
+			task();
+			task = nullptr; //release what the task captured before wait() can return
+			if (--pending == 0)
+			{
+				lock_guard<mutex> guard(idleLock);
+				finished.notify_all();
+			}
+			continue;
+		}
+
+		unique_lock<mutex> guard(idleLock);
+		idle.wait(guard, [&] { return stopping || queued > 0; });
+		if (stopping && queued == 0)
+			return;
+	}
+}
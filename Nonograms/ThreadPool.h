@@ -0,0 +1,50 @@
+//a fixed set of worker threads, each with its own task deque, idle workers steal from the others
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+using std::atomic;
+using std::function;
+using std::vector;
+
+class ThreadPool
+{
+	public:
+		explicit ThreadPool(int threads); //at least one worker
+		~ThreadPool(); //finishes every submitted task, then joins the workers
+
+		//tasks submitted from a worker go on its own deque and run newest first, others are spread round robin
+		void submit(function<void()> task);
+		void wait(); //block until every submitted task has finished
+
+		int size() const { return workers.size(); }
+		static int defaultThreads(); //hardware threads, 1 if unknown
+	private:
+		struct Worker
+		{
+			std::deque<function<void()>> tasks;
+			std::mutex lock;
+		};
+
+		bool take(int self, function<void()>& task); //own newest task, else the oldest task of another worker
+		void run(int self);
+
+		vector<std::unique_ptr<Worker>> workers;
+		vector<std::thread> threads;
+		std::mutex idleLock;
+		std::condition_variable idle; //workers wait here for tasks
+		std::condition_variable finished; //wait() waits here for pending to reach 0
+		atomic<int> queued; //tasks sitting in deques
+		atomic<int> pending; //tasks submitted and not yet finished
+		atomic<unsigned> nextWorker;
+		bool stopping = false;
+};
+
+#endif